@@ -55,6 +55,7 @@ void Beach::load() {
 	settings.ambientLightVector = { 0, -0.25, -0.75 };
 	settings.brightness = 0.2;
 	settings.hasStaticAmbientLight = true;
+	settings.hasOpaqueBackground = true;
 }
 
 void Beach::onUpdate(int dt) {
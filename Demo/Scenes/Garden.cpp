@@ -180,6 +180,8 @@ void Garden::load() {
 	settings.ambientLightVector = { 0, -0.8f, 0.5f };
 	settings.ambientLightFactor = 0.5f;
 	settings.hasStaticAmbientLight = true;
+	settings.hasOpaqueBackground = true;
+	settings.perspectiveSpanLength = 16;
 }
 
 void Garden::onUpdate(int dt) {
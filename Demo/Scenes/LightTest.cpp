@@ -121,6 +121,17 @@ void LightTest::load() {
 	add(light3);
 	add(light4);
 
+	// Clicking a cube moves the yellow light just in front of it
+	inputManager->onMouseClick([=]() {
+		Object* object = pickObjectInView();
+
+		if (object != NULL && object->isOfType<Cube>()) {
+			const BoundingSphere& boundingSphere = object->getBoundingSphere();
+
+			yellowLight->position = object->position + boundingSphere.center - camera->getDirection() * (boundingSphere.radius + 50.0f);
+		}
+	});
+
 	settings.visibility = 4000;
 	settings.brightness = 0.1;
 	settings.ambientLightColor = { 0, 0, 255 };
@@ -1,11 +1,43 @@
 #include <SDL.h>
 #include <math.h>
+#include <stdio.h>
 #include <Scenes/TextureTest.h>
 #include <System/Objects.h>
 #include <Graphics/TextureBuffer.h>
 #include <System/Math.h>
 #include <UI/UIObjects.h>
 
+/**
+ * BenchmarkView
+ * -------------
+ *
+ * A camera angle for the texture layout benchmark, chosen to walk
+ * across textures horizontally, diagonally or vertically in texture
+ * space.
+ */
+struct BenchmarkView {
+	const char* name;
+	float yaw;
+	float pitch;
+};
+
+static const BenchmarkView benchmarkViews[] = {
+	{ "Floor, ahead", 0.0f, -0.3f },
+	{ "Floor, diagonal", 0.8f, -0.3f },
+	{ "Floor, sideways", 1.57f, -0.3f },
+	{ "Floor, overhead", 0.4f, -1.4f },
+	{ "Wall, oblique", -0.6f, 0.0f },
+	{ "Wall, glancing", -0.3f, 0.1f }
+};
+
+static const char* benchmarkLayoutNames[] = {
+	"row-major",
+	"tiled"
+};
+
+constexpr static int BENCHMARK_WARMUP_FRAMES = 15;
+constexpr static int BENCHMARK_FRAMES = 60;
+
 /**
  * TextureTest
  * -----------
@@ -43,6 +75,30 @@ void TextureTest::load() {
 		add(c);
 	}
 
+	add("floorTexture", new TextureBuffer("./DemoAssets/ground-texture.png"));
+	add("wallTexture", new TextureBuffer("./DemoAssets/wall.png"));
+
+	Mesh* floor = new Mesh(40, 40, 100);
+	floor->setTexture(getTexture("floorTexture"));
+	floor->setTextureInterval(2, 2);
+	floor->position = { -2000, -250, 0 };
+	floor->isStatic = true;
+
+	add(floor);
+
+	Mesh* wall = new Mesh(40, 8, 100);
+	wall->setTexture(getTexture("wallTexture"));
+	wall->setTextureInterval(4, 4);
+	wall->rotateDeg({ 0, 0, 90 });
+	wall->position = { 1500, -250, 0 };
+	wall->isStatic = true;
+
+	add(wall);
+
+	inputManager->onKeyUp([=](const SDL_Keycode& code) {
+		onKeyUp(code);
+	});
+
 	UIGraphic* hud = new UIGraphic("./DemoAssets/hud.png");
 	hud->position.x = 1000;
 	hud->position.y = 10;
@@ -56,3 +112,78 @@ void TextureTest::load() {
 	settings.ambientLightFactor = 0.7;
 	settings.hasStaticAmbientLight = true;
 }
+
+void TextureTest::onKeyUp(const SDL_Keycode& code) {
+	if (code == SDLK_b && !isBenchmarking) {
+		startBenchmark();
+	}
+}
+
+void TextureTest::onUpdate(int dt) {
+	if (isBenchmarking) {
+		updateBenchmark();
+	}
+}
+
+void TextureTest::printBenchmarkResults() {
+	printf("[TextureTest] Texture layout benchmark (average draw time over %d frames, excluding present/vsync)\n", BENCHMARK_FRAMES);
+
+	for (int view = 0; view < TOTAL_BENCHMARK_VIEWS; view++) {
+		printf("[TextureTest] %-16s", benchmarkViews[view].name);
+
+		for (int layout = 0; layout < TOTAL_BENCHMARK_LAYOUTS; layout++) {
+			printf("  %s: %.2fms", benchmarkLayoutNames[layout], (float)benchmarkTimes[view][layout] / BENCHMARK_FRAMES);
+		}
+
+		printf("\n");
+	}
+
+	fflush(stdout);
+}
+
+void TextureTest::setTextureLayout(TextureLayout layout) {
+	getTexture("floorTexture")->setLayout(layout);
+	getTexture("wallTexture")->setLayout(layout);
+}
+
+/**
+ * Starts a benchmark comparing draw times for each texture layout
+ * across a fixed set of camera angles. Each layout is given a few
+ * frames at each angle to warm up before its draw times are taken.
+ * Only the rasterizer's draw stage is timed, since whole frames are
+ * held to the display's refresh interval by vsync.
+ */
+void TextureTest::startBenchmark() {
+	isBenchmarking = true;
+	benchmarkStep = 0;
+	benchmarkFrame = 0;
+
+	camera->position = { 0, 0, 0 };
+}
+
+void TextureTest::updateBenchmark() {
+	int view = benchmarkStep / TOTAL_BENCHMARK_LAYOUTS;
+	int layout = benchmarkStep % TOTAL_BENCHMARK_LAYOUTS;
+
+	if (benchmarkFrame == 0) {
+		setTextureLayout((TextureLayout)layout);
+
+		benchmarkTimes[view][layout] = 0;
+	} else if (benchmarkFrame > BENCHMARK_WARMUP_FRAMES) {
+		benchmarkTimes[view][layout] += controller->getDrawTime();
+	}
+
+	camera->yaw = benchmarkViews[view].yaw;
+	camera->pitch = benchmarkViews[view].pitch;
+
+	if (++benchmarkFrame > BENCHMARK_WARMUP_FRAMES + BENCHMARK_FRAMES) {
+		benchmarkFrame = 0;
+
+		if (++benchmarkStep == TOTAL_BENCHMARK_VIEWS * TOTAL_BENCHMARK_LAYOUTS) {
+			isBenchmarking = false;
+
+			setTextureLayout(TextureLayout::ROW_MAJOR);
+			printBenchmarkResults();
+		}
+	}
+}
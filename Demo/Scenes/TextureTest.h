@@ -1,8 +1,26 @@
 #pragma once
 
 #include <System/Scene.h>
+#include <Graphics/TextureBuffer.h>
+#include <SDL.h>
 
 class TextureTest : public Scene {
 public:
 	void load() override;
+	void onUpdate(int dt) override;
+
+private:
+	constexpr static int TOTAL_BENCHMARK_VIEWS = 6;
+	constexpr static int TOTAL_BENCHMARK_LAYOUTS = 2;
+
+	bool isBenchmarking = false;
+	int benchmarkStep = 0;
+	int benchmarkFrame = 0;
+	int benchmarkTimes[TOTAL_BENCHMARK_VIEWS][TOTAL_BENCHMARK_LAYOUTS];
+
+	void onKeyUp(const SDL_Keycode& code);
+	void printBenchmarkResults();
+	void setTextureLayout(TextureLayout layout);
+	void startBenchmark();
+	void updateBenchmark();
 };
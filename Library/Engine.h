@@ -2,6 +2,7 @@
 
 #include <cmath>
 #include <map>
+#include <string>
 #include <vector>
 
 #include <SDL.h>
@@ -23,34 +24,45 @@
 #include <Sound/AudioEngine.h>
 
 /**
- * FrustumCuller
- * -------------
+ * FrustumOutcode
+ * --------------
  *
- * Aggregates counter variables for polygon vertices culled on
- * any sides of the viewing frustum, and provides a simple
- * mechanism for determining whether the represented polygon
- * should be culled from rendering.
+ * Bits identifying which sides of the viewing frustum a vertex
+ * lies outside of.
+ *
+ * In order to correctly determine whether a polygon is culled,
+ * we need to ensure that all of its vertices are culled on a
+ * particular side of the viewing frustum. Since checks are
+ * per-vertex, a polygon with some vertices culled on one side
+ * and some on another might actually spread across the screen,
+ * meaning that it should nevertheless be rendered. This becomes
+ * significant when viewing polygons from extremely close up.
+ * A polygon is thus only culled when its vertex outcodes share
+ * at least one bit.
  */
-struct FrustumCuller {
-	int top = 0;
-	int bottom = 0;
-	int left = 0;
-	int right = 0;
-	int near = 0;
-	int far = 0;
+enum FrustumOutcode {
+	FRUSTUM_NEAR = 1 << 0,
+	FRUSTUM_FAR = 1 << 1,
+	FRUSTUM_LEFT = 1 << 2,
+	FRUSTUM_RIGHT = 1 << 3,
+	FRUSTUM_BOTTOM = 1 << 4,
+	FRUSTUM_TOP = 1 << 5
+};
 
-	/**
-	 * In order to correctly determine whether a polygon is culled,
-	 * we need to ensure that all of its vertices are culled on a
-	 * particular side of the viewing frustum. Since checks are
-	 * per-vertex, a polygon with some vertices culled on one side
-	 * and some on another might actually spread across the screen,
-	 * meaning that it should nevertheless be rendered. This becomes
-	 * significant when viewing polygons from extremely close up.
-	 */
-	bool isCulled() {
-		return left == 3 || right == 3 || top == 3 || bottom == 3 || near == 3 || far == 3;
-	}
+/**
+ * ViewSpaceCache
+ * --------------
+ *
+ * View space vectors, unit vectors and frustum outcodes for each
+ * of an Object's vertices, computed once per frame so that every
+ * polygon sharing a vertex can assemble its triangle from them by
+ * vertex index. Storage is reused from one Object to the next, so
+ * it only grows to fit the largest Object in the scene.
+ */
+struct ViewSpaceCache {
+	std::vector<Vec3> vectors;
+	std::vector<Vec3> unitVectors;
+	std::vector<int> outcodes;
 };
 
 /**
@@ -62,6 +74,7 @@ public:
 	Engine(int width, int height, const char* title, const char* iconPath, const char* debugFontPath, int flags = 0);
 	~Engine();
 
+	int getDrawTime();
 	int getFlags();
 	int getWindowHeight();
 	int getWindowWidth();
@@ -89,7 +102,11 @@ private:
 	Area windowArea;
 	Region rasterLockRegion = { 0, 0, 100, 100 };
 	Region rasterRegion;
+	Area maxRasterArea;
+	Area rasterArea;
 	Area halfRasterArea;
+	int rasterScale = 100;
+	SkyboxView skyboxView;
 
 	enum RenderStep {
 		ILLUMINATION,
@@ -101,6 +118,38 @@ private:
 		int sectionId;
 		RenderStep step;
 		bool isWorking = false;
+		bool isProjecting = false;
+	};
+
+	/**
+	 * ProjectedObject
+	 * ---------------
+	 *
+	 * An Object queued for screen projection on the current frame,
+	 * along with the LOD to be projected and the offset of its first
+	 * polygon among all polygons queued before it.
+	 */
+	struct ProjectedObject {
+		const Object* object;
+		const Object* lodObject;
+		int polygonOffset;
+	};
+
+	/**
+	 * ProjectionSection
+	 * -----------------
+	 *
+	 * A contiguous range of the current frame's queued polygons, and
+	 * the state needed to project them independently of other ranges.
+	 * Each section projects Triangles from its own triangle sub-pool
+	 * into its own RasterFilter, so sections can be projected on
+	 * separate threads and merged afterward in section order.
+	 */
+	struct ProjectionSection {
+		RasterFilter* rasterFilter = NULL;
+		ViewSpaceCache viewSpaceCache;
+		int start = 0;
+		int end = 0;
 	};
 
 	RenderWorkerManager* renderWorkerManagers;
@@ -108,15 +157,25 @@ private:
 	SDL_Thread* renderThread = NULL;
 	bool isRendering = false;
 	int frame = 0;
+	std::vector<Object*> viewableObjects;
+	std::vector<ProjectedObject> projectedObjects;
+	std::vector<ProjectionSection> projectionSections;
+	RotationMatrix cameraRotationMatrix;
+	float projectionScale;
+	float fovAngleRange;
 
 	static int handleRenderWorkerThread(void* data);
 	static int handleRenderThread(void* data);
 	void awaitRenderStep(RenderStep renderStep);
+	void awaitScreenProjection(int totalSections);
 	void createRenderThreads();
+	bool isObjectCulled(const Object* object, const Vec3& relativeObjectPosition);
+	bool isSphereCulled(const Vec3& center, float radius);
 	void precomputeStaticLightColorIntensities();
 
 	void projectAndQueueTriangle(
-		const Vertex3d (&vertexes)[3],
+		int sectionIndex,
+		const ViewVertex (&vertexes)[3],
 		const Vec3 (&unitVecs)[3],
 		const Vec3 (&worldVecs)[3],
 		const Polygon* sourcePolygon,
@@ -125,13 +184,16 @@ private:
 		bool isSynthetic
 	);
 
+	void projectSection(int sectionIndex);
 	void resizeRasterRegion();
 	void setWindowIcon(const char* icon);
+	void updateRasterArea();
 	void updateScene_MultiThreaded();
 	void updateScene_SingleThreaded();
 	void updateScene_Wireframe();
 	void updateScreenProjection();
 	void updateSounds();
+	void updateViewSpaceCache(ViewSpaceCache& cache, const Object* object, const Vec3& relativeObjectPosition, int firstVertex, int endVertex);
 
 	/* --- DEBUGGING -- */
 
@@ -144,6 +206,7 @@ private:
 
 	void addDebugStat(const char* key);
 	void updateDebugStat(const char* key, const char* label, int debugValue);
+	void updateDebugStat(const char* key, const char* label, const std::string& debugValue);
 	void updateDebugStats();
 
 	void showCommandLine();
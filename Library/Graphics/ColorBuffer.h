@@ -2,12 +2,49 @@
 
 #include <SDL.h>
 #include <Graphics/Color.h>
+#include <vector>
+
+/**
+ * TextureLayout
+ * -------------
+ *
+ * The order in which texels are stored in memory. Row-major
+ * texels are stored one row after another. Tiled texels are
+ * stored in 4x4 tiles, themselves stored one row of tiles after
+ * another, so that samples close to one another in any direction
+ * across a texture tend to fall within the same cache lines.
+ */
+enum TextureLayout {
+	ROW_MAJOR,
+	TILED
+};
+
+/**
+ * TextureOpacity
+ * --------------
+ *
+ * Whether a texture or mipmap contains any transparent texels.
+ * Alpha-tested textures and mipmaps contain transparent texels
+ * which must be tested for when sampled, whereas fully opaque
+ * ones can be sampled without any such tests. Mixed textures
+ * have both fully opaque and alpha-tested mipmaps, since their
+ * smaller mipmaps may average their transparent texels away.
+ */
+enum TextureOpacity {
+	FULLY_OPAQUE,
+	ALPHA_TESTED,
+	MIXED
+};
 
 /**
  * ColorBuffer
  * -----------
  *
- * A buffer of Color objects representing texture data.
+ * A buffer of packed ARGB texels representing texture data.
+ * The buffer has an extra column and row of guard texels, which
+ * repeat the first column and row, so that texture coordinates
+ * wrapped into the [0, 1] range always map to a readable texel
+ * without any bounds checks.
  */
 class ColorBuffer {
 public:
@@ -17,14 +54,58 @@ public:
 	ColorBuffer(int width, int height);
 	~ColorBuffer();
 
+	void analyzeOpacity();
 	ColorBuffer* createDownsizedBuffer();
-	const Color& read(int index) const;
-	const Color& read(int x, int y) const;
+	const Uint32* getBuffer() const;
+	int getBufferSize() const;
+	TextureLayout getLayout() const;
+	TextureOpacity getOpacity() const;
+	int getStride() const;
+	Uint32 read(int x, int y) const;
+	void setLayout(TextureLayout layout);
 	void write(int x, int y, int R, int G, int B);
 
-private:
-	inline int getIndex(int x, int y) const;
+	/**
+	 * Returns the offset of a texel in the buffer for the
+	 * buffer's current layout.
+	 */
+	inline int getTexelIndex(int x, int y) const {
+		if (layout == TextureLayout::TILED) {
+			return (((y >> 2) * stride + (x >> 2)) << 4) | ((y & 3) << 2) | (x & 3);
+		}
+
+		return y * stride + x;
+	}
+
+	/**
+	 * Reads a texel without bounds checking. Any x from 0
+	 * through width and y from 0 through height is valid.
+	 */
+	inline Uint32 readUnchecked(int x, int y) const {
+		return buffer[getTexelIndex(x, y)];
+	}
 
-	Color* buffer = NULL;
+	/**
+	 * Determines whether a texel is opaque from the buffer's
+	 * coverage mask, without bounds checking. Valid texels are
+	 * the same as for readUnchecked(). Only alpha-tested buffers
+	 * have a coverage mask, so this must not be used on fully
+	 * opaque buffers.
+	 */
+	inline bool isOpaqueUnchecked(int x, int y) const {
+		int index = y * (width + 1) + x;
+
+		return (coverageMask[index >> 5] >> (index & 31)) & 1;
+	}
+
+private:
+	Uint32* buffer = NULL;
 	int bufferSize;
+	TextureLayout layout = TextureLayout::ROW_MAJOR;
+	TextureOpacity opacity = TextureOpacity::FULLY_OPAQUE;
+	std::vector<Uint32> coverageMask;
+	int stride;
+
+	void allocate();
+	void writeTexel(int x, int y, Uint32 color);
 };
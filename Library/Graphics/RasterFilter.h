@@ -32,7 +32,9 @@ public:
 	RasterFilter(int width, int height);
 
 	void addTriangle(Triangle* triangle);
+	void merge(RasterFilter* filter);
 	Triangle* next();
+	void setResolution(int width, int height);
 
 private:
 	/**
@@ -1,27 +1,325 @@
 #pragma once
 
 #include <SDL.h>
+#include <array>
+#include <utility>
 #include <vector>
 #include <limits.h>
 #include <System/Math.h>
 #include <System/Geometry.h>
 #include <Helpers.h>
 #include <Graphics/TextureBuffer.h>
+#include <Graphics/ColorBuffer.h>
 #include <Constants.h>
 
+/**
+ * RasterMode
+ * ----------
+ */
+enum RasterMode {
+	SCANLINE,
+	TILE
+};
+
+/**
+ * ShadingMode
+ * -----------
+ *
+ * In forward shading mode, every pixel passing the depth test is
+ * shaded immediately. In deferred shading mode, rasterization only
+ * writes depth and triangle IDs to a visibility buffer, and each
+ * band's visible pixels are shaded exactly once after all of its
+ * triangles have been rasterized, avoiding the cost of shading
+ * pixels which are later overdrawn. In span buffer mode, each screen
+ * row keeps a depth-sorted list of visible span segments, and new
+ * spans are clipped against the segments already in their row before
+ * anything is shaded, so that every opaque pixel is shaded once and
+ * opaque geometry never has to test against the depth buffer.
+ */
+enum ShadingMode {
+	FORWARD,
+	DEFERRED,
+	SPAN_BUFFER
+};
+
+/**
+ * SpanKernelFeatures
+ * ------------------
+ *
+ * Features which a span kernel permutation supports. Each
+ * combination of features is compiled as a separate kernel,
+ * selected once per triangle at dispatch time, so that the
+ * per-pixel loops only do the work required for a given
+ * triangle. Fog and lighting are baked into vertex colors
+ * for untextured triangles, so they only affect textured
+ * kernels. Subdivided kernels map textures affinely between
+ * exact perspective divides at fixed intervals along a span,
+ * rather than dividing at each sample. Subdivided kernels for
+ * textures with power-of-two dimensions step their texture
+ * coordinates in fixed point, wrapping them with bitmasks.
+ */
+enum SpanKernelFeatures {
+	SPAN_TEXTURED = 1 << 0,
+	SPAN_FOGGED = 1 << 1,
+	SPAN_ALPHA_TESTED = 1 << 2,
+	SPAN_LIT = 1 << 3,
+	SPAN_SUBDIVIDED = 1 << 4,
+	SPAN_POWER_OF_TWO = 1 << 5
+};
+
+constexpr static int TOTAL_SPAN_KERNELS = 64;
+
+/**
+ * Interpolants
+ * ------------
+ *
+ * The set of vertex attributes interpolated across the surface
+ * of a triangle during rasterization. Depending on context this
+ * may represent attribute values at a particular pixel, or the
+ * per-pixel change in those values along a given axis.
+ */
+struct Interpolants {
+	float inverseDepth = 0.0f;
+	Vec2 perspectiveUV;
+	Vec3 textureIntensity;
+	Vec3 color;
+};
+
+/**
+ * ScanlineTexturing
+ * -----------------
+ */
+struct ScanlineTexturing {
+	Vec2 perspectiveUV;
+	Vec3 textureIntensity;
+};
+
+/**
+ * AffineTextureSpan
+ * -----------------
+ *
+ * Texture coordinates and depth interpolated linearly across a
+ * segment of a span, between exact perspective divides at either
+ * end of the segment. Segment end values are a function of their
+ * offset along the span alone, so the values at the end of one
+ * segment are reused as the start values of the next whenever the
+ * two are contiguous, with the same result as dividing again.
+ */
+struct AffineTextureSpan {
+	float u = 0.0f;
+	float v = 0.0f;
+	float depth = 0.0f;
+	float uStep = 0.0f;
+	float vStep = 0.0f;
+	float depthStep = 0.0f;
+	float uEnd = 0.0f;
+	float vEnd = 0.0f;
+	float depthEnd = 0.0f;
+	int fixedU = 0;
+	int fixedV = 0;
+	int fixedUStep = 0;
+	int fixedVStep = 0;
+	int start = -1;
+	int end = -1;
+
+	/**
+	 * Moves the span to the segment between pixel offsets start and
+	 * end from the pixel at which the given attribute values apply.
+	 */
+	inline void subdivide(const Interpolants& values, const Interpolants& step, int start, int end) {
+		if (start == this->end) {
+			u = uEnd;
+			v = vEnd;
+			depth = depthEnd;
+		} else {
+			divide(values, step, start, u, v, depth);
+		}
+
+		divide(values, step, end, uEnd, vEnd, depthEnd);
+
+		float inverseLength = 1.0f / (float)FAST_MAX(end - start, 1);
+
+		uStep = (uEnd - u) * inverseLength;
+		vStep = (vEnd - v) * inverseLength;
+		depthStep = (depthEnd - depth) * inverseLength;
+
+		this->start = start;
+		this->end = end;
+	}
+
+	/**
+	 * Converts the segment's texture coordinates into fixed point
+	 * texels of a mipmap with power-of-two dimensions. Starting
+	 * coordinates are wrapped into the texture's first repetition
+	 * and steps are clamped so that stepping to the end of the
+	 * segment can't overflow, leaving any further wrapping to the
+	 * sampler's bitmasks. Clamping only affects segments stepping
+	 * across hundreds of texels per pixel, which no mipmap level
+	 * is sampled at in practice.
+	 */
+	inline void toFixedPoint(int width, int height) {
+		constexpr float scale = (float)(1 << TEXEL_FIXED_POINT_SHIFT);
+		float maxStep = (float)(INT_MAX / 2) / (float)FAST_MAX(end - start, 1);
+
+		fixedU = (int)((u - floorf(u)) * width * scale);
+		fixedV = (int)((v - floorf(v)) * height * scale);
+		fixedUStep = (int)FAST_CLAMP(uStep * width * scale, -maxStep, maxStep);
+		fixedVStep = (int)FAST_CLAMP(vStep * height * scale, -maxStep, maxStep);
+	}
+
+	static inline void divide(const Interpolants& values, const Interpolants& step, int offset, float& u, float& v, float& depth) {
+		float x = (float)offset;
+
+		depth = 1.0f / (values.inverseDepth + step.inverseDepth * x);
+		u = (values.perspectiveUV.x + step.perspectiveUV.x * x) * depth;
+		v = (values.perspectiveUV.y + step.perspectiveUV.y * x) * depth;
+	}
+};
+
 /**
  * Scanline
  * --------
+ *
+ * A single row of a triangle, storing its attribute values at its
+ * starting pixel along with the index of its triangle's setup, from
+ * which per-pixel attribute steps are read. Textured Scanlines only
+ * need their texture coordinates and intensities, while untextured
+ * Scanlines only need their vertex colors, so the two share storage
+ * to keep Scanline blocks small.
  */
 struct Scanline {
 	int x = 0;
 	int y = 0;
 	int length = 0;
-	Range<Color> color;
-	Range<float> inverseDepth;
-	Range<Vec2> perspectiveUV;
-	Range<Vec3> textureIntensity;
+	int triangleSetup = 0;
+	float inverseDepth = 0.0f;
+
+	union {
+		Vec3 color;
+		ScanlineTexturing texturing;
+	};
+
+	Scanline() {}
+};
+
+/**
+ * TriangleEdge
+ * ------------
+ *
+ * An edge function E(x, y) = a * x + b * y + c, which is >= 0
+ * for screen coordinates on the inner side of a triangle edge.
+ */
+struct TriangleEdge {
+	int a;
+	int b;
+	long long c;
+
+	inline long long at(int x, int y) const {
+		return (long long)a * x + (long long)b * y + c;
+	}
+};
+
+/**
+ * TriangleSetup
+ * -------------
+ *
+ * Edge functions, screen bounds, and attribute gradients for
+ * a triangle, computed once at dispatch time so that its
+ * attributes can be evaluated directly at any pixel during
+ * tile rasterization, or stepped across its Scanlines.
+ */
+struct TriangleSetup {
+	TriangleEdge edges[3];
+	Coordinate origin;
+	Coordinate topLeft;
+	Coordinate bottomRight;
+	Interpolants start;
+	Interpolants dx;
+	Interpolants dy;
+	float maxInverseDepth;
 	const TextureBuffer* texture;
+	const ColorBuffer* mipmap;
+	int textureSampleInterval;
+	int spanKernel;
+};
+
+/**
+ * SpanSegment
+ * -----------
+ *
+ * A visible section of a span in a span buffer row, covering
+ * screen pixels start through end (inclusive).
+ */
+struct SpanSegment {
+	int start;
+	int end;
+	float inverseDepth;
+	float inverseDepthStep;
+	int triangleSetup;
+};
+
+/**
+ * RasterBand
+ * ----------
+ *
+ * A bucket of Scanlines (in scanline mode) or triangles (in tile
+ * mode) falling within a contiguous band of screen rows. Work is
+ * binned into bands as triangles are dispatched, so that each band
+ * can be rasterized by a single render worker without reading any
+ * other band's work or writing to any other band's pixels. Scanline
+ * storage is claimed from the shared Scanline store in fixed-size
+ * blocks, allowing heavily populated bands (e.g. those near the
+ * horizon) to grow at the expense of sparse ones. In span buffer
+ * mode, each band also owns the span segment lists for its rows.
+ */
+struct RasterBand {
+	std::vector<Scanline*> blocks;
+	int totalScanlines = 0;
+	std::vector<int> triangleSetups;
+	int totalSpans[TOTAL_SPAN_KERNELS] = { 0 };
+	std::vector<SpanSegment> spanSegments[RASTER_BAND_HEIGHT];
+	std::vector<SpanSegment> mergedSpanSegments;
+};
+
+/**
+ * Framebuffer
+ * -----------
+ *
+ * A texture which frames are presented from, along with the pixels
+ * a frame is rasterized into. For streaming textures, the pixels are
+ * the texture's own, locked from the time the framebuffer is cleared
+ * until it is presented. The framebuffer also records the resolution
+ * and row pitch of its frame, since these may change before the frame
+ * is presented.
+ */
+struct Framebuffer {
+	SDL_Texture* texture = NULL;
+	Uint32* pixels = NULL;
+	bool isStreaming = false;
+	bool isLocked = false;
+	int width = 0;
+	int height = 0;
+	int pitch = 0;
+};
+
+/**
+ * SkyboxView
+ * ----------
+ *
+ * The view of a skybox texture from the camera for a given frame.
+ * The view direction through each pixel, in the skybox's unrotated
+ * space, is linear in screen space, so it's defined by the direction
+ * through the first pixel of the screen, along with its change per
+ * pixel along either screen axis. Directions are scaled to a view
+ * space depth of 1, so the depth at which each pixel's view ray meets
+ * the skybox follows from the distance to its faces.
+ */
+struct SkyboxView {
+	const TextureBuffer* texture = NULL;
+	Vec3 direction;
+	Vec3 xStep;
+	Vec3 yStep;
+	float distance = 0.0f;
 };
 
 /**
@@ -35,48 +333,157 @@ public:
 
 	void clear();
 	void dispatchTriangle(Triangle& triangle);
+	int getTotalBands();
 	int getTotalBufferedScanlines();
-	const Scanline* getScanline(int index);
+	int getTotalSpans(int spanKernel);
 	void line(int x1, int y1, int x2, int y2);
+	void rasterizeBand(int bandIndex);
 	void render(SDL_Renderer* renderer, int sizeFactor);
+	void renderPreviousFrame(SDL_Renderer* renderer, int sizeFactor);
 	void setBackgroundColor(const Color& color);
+	void setBackgroundCovered(bool isBackgroundCovered);
+	void setDepthEpochs(bool useDepthEpochs);
 	void setDrawColor(int R, int G, int B);
 	void setDrawColor(const Color& color);
 	void setDrawColor(Uint32 color);
 	void setOffset(const Coordinate& offset);
+	void setPerspectiveSpanLength(int perspectiveSpanLength);
+	void setRasterMode(RasterMode rasterMode);
+	void setResolution(int width, int height);
+	void setShadingMode(ShadingMode shadingMode);
+	void setSkyboxView(const SkyboxView& skyboxView);
 	void setVisibility(int visibility);
 	void triangle(int x1, int y1, int x2, int y2, int x3, int y3);
-	void triangleScanline(const Scanline* scanline);
 
 private:
-	Scanline* scanlines;
-	int totalBufferedScanlines = 0;
+	typedef void (Rasterizer::*SpanKernel)(
+		int x1, int x2, int start, int end, int y,
+		const Interpolants& values,
+		const Interpolants& step,
+		const TextureBuffer* texture,
+		const ColorBuffer* mipmap,
+		int textureSampleInterval
+	);
+
+	typedef void (Rasterizer::*ResolveKernel)(const TriangleSetup& setup, int start, int end, int y);
+
+	static const std::array<SpanKernel, TOTAL_SPAN_KERNELS> spanKernels;
+	static const std::array<ResolveKernel, TOTAL_SPAN_KERNELS> resolveKernels;
+
+	RasterMode rasterMode = RasterMode::SCANLINE;
+	ShadingMode shadingMode = ShadingMode::FORWARD;
+	bool isBackgroundCovered = false;
+	bool useDepthEpochs = false;
+	Uint32 depthEpoch = 0;
+	std::vector<Scanline*> scanlineBlocks;
+	RasterBand* bands;
+	int totalBands;
+	int totalAllocatedBands;
+	int totalClaimedScanlineBlocks = 0;
+	std::vector<TriangleSetup> triangleSetups;
 	Color backgroundColor = { 0, 0, 0 };
 	Uint32 drawColor = ARGB(255, 255, 255);
 	int visibility = MAX_VISIBILITY;
-	SDL_Texture* screenTexture;
-	Uint32* pixelBuffer;
+	int perspectiveSpanLength = 0;
+	SkyboxView skyboxView;
+	Framebuffer framebuffers[TOTAL_FRAMEBUFFERS];
+	int currentFramebuffer = 0;
+	bool hasStreamingTextures = false;
+	Uint32* pixelBuffer = NULL;
 	float* depthBuffer;
-	int bufferSize;
+	Uint32* rowDepthEpochs;
+	Uint32* visibilityBuffer;
+	float* tileDepthBuffer;
+	float* tileRowDepthBuffer;
+	int totalTileColumns;
+	int totalTileRows;
 	Coordinate offset;
 	int width;
 	int height;
+	int bufferWidth;
+	int bufferHeight;
+	int pitch;
+
+	static constexpr int getSpanKernelPermutation(int spanKernel);
+
+	template<size_t... spanKernel>
+	static constexpr std::array<ResolveKernel, TOTAL_SPAN_KERNELS> createResolveKernels(std::index_sequence<spanKernel...>);
+
+	template<size_t... spanKernel>
+	static constexpr std::array<SpanKernel, TOTAL_SPAN_KERNELS> createSpanKernels(std::index_sequence<spanKernel...>);
 
-	void dispatchFlatTriangle(const Vertex2d& corner, const Vertex2d& left, const Vertex2d& right, const TextureBuffer* texture);
-	void dispatchFlatBottomTriangle(const Vertex2d& top, const Vertex2d& bottomLeft, const Vertex2d& bottomRight, const TextureBuffer* texture);
-	void dispatchFlatTopTriangle(const Vertex2d& topLeft, const Vertex2d& topRight, const Vertex2d& bottom, const TextureBuffer* texture);
+	void clearBand(int bandIndex);
+	void clearRowDepth(int y);
+	void createFramebuffers(SDL_Renderer* renderer);
+	void dispatchFlatTriangle(const Coordinate& corner, const Coordinate& left, const Coordinate& right, int setupIndex);
+	void dispatchFlatBottomTriangle(const Coordinate& top, const Coordinate& bottomLeft, const Coordinate& bottomRight, int setupIndex);
+	void dispatchFlatTopTriangle(const Coordinate& topLeft, const Coordinate& topRight, const Coordinate& bottom, int setupIndex);
+	void dispatchTileTriangle(const Triangle& triangle);
 	void flushScanlines();
+	Scanline* requestScanline(int y);
 	int getColorLerpInterval(const Color& start, const Color& end, int lineLength);
-	int getMipmapLevel(float averageDepth);
+	int getMipmapLevel(float texelsPerPixel);
+	int getSpanKernel(const Triangle& triangle, const ColorBuffer* mipmap);
 	int getTextureSampleInterval(int lineLength, float averageDepth);
+	void insertSpanSegment(const SpanSegment& segment, int y);
+	void lockFramebuffer(Framebuffer& framebuffer);
+	void rasterizeTile(const TriangleSetup& setup, int setupIndex, int tileX, int tileY);
+	void rasterizeBandTriangles(int bandIndex, bool includeOpaque, bool includeAlphaTested);
+	void rasterizeTileBand(const RasterBand& band, int bandIndex, bool includeOpaque, bool includeAlphaTested);
+	void refreshRowDepth(int y);
+	void renderFramebuffer(SDL_Renderer* renderer, Framebuffer& framebuffer, int sizeFactor);
+	void resolveSpanBufferBand(int bandIndex);
+	void resolveVisibilityBand(int bandIndex);
+
+	template<int spanKernel>
+	void resolveVisibilityRun(const TriangleSetup& setup, int start, int end, int y);
+
 	void setPixel(int x, int y);
+	int setupTriangle(const Triangle& triangle);
+	void shadeSkyboxBand(int bandIndex);
+	void triangleScanline(const Scanline* scanline);
 
 	void triangleScanline(
-		int x1, int y1, int length,
-		const Range<Color>& color,
-		const Range<float>& inverseDepth,
-		const Range<Vec2>& perspectiveUV,
-		const Range<Vec3>& textureIntensity,
-		const TextureBuffer* texture
+		int x1, int x2, int y,
+		const Interpolants& values,
+		const Interpolants& step,
+		const TextureBuffer* texture,
+		const ColorBuffer* mipmap,
+		int textureSampleInterval,
+		int spanKernel,
+		int setupIndex
+	);
+
+	template<int spanKernel>
+	void triangleScanlineRun(
+		int x1, int x2, int start, int end, int y,
+		const Interpolants& values,
+		const Interpolants& step,
+		const TextureBuffer* texture,
+		const ColorBuffer* mipmap,
+		int textureSampleInterval
 	);
+
+#if defined(__AVX2__)
+	template<int spanKernel>
+	void triangleScanlineRunAVX2(
+		int x1, int x2, int start, int end, int y,
+		const Interpolants& values,
+		const Interpolants& step,
+		const ColorBuffer* mipmap,
+		int textureSampleInterval
+	);
+#endif
+
+	template<bool isAlphaTested>
+	void triangleScanlineVisibilityRun(
+		int x1, int start, int end, int y,
+		const Interpolants& values,
+		const Interpolants& step,
+		const TextureBuffer* texture,
+		const ColorBuffer* mipmap,
+		Uint32 triangleId
+	);
+
+	void updateTileDepth(int start, int end, int y);
 };
@@ -3,6 +3,7 @@
 #include <SDL.h>
 #include <Graphics/Color.h>
 #include <Graphics/ColorBuffer.h>
+#include <Constants.h>
 #include <vector>
 
 /**
@@ -23,6 +24,8 @@ struct TextureBuffer {
 	int height = 0;
 	int totalPixels = 0;
 	bool shouldUseMipmaps = true;
+	TextureOpacity opacity = TextureOpacity::FULLY_OPAQUE;
+	bool isPowerOfTwo = false;
 
 	TextureBuffer(const char* file);
 	~TextureBuffer();
@@ -30,13 +33,64 @@ struct TextureBuffer {
 	static Uint32 readPixel(SDL_Surface* surface, int index);
 	void confirmTexture(SDL_Renderer* renderer, TextureMode mode);
 	const ColorBuffer* getMipmap(int level) const;
-	const Color& sample(float u, float v, const ColorBuffer* mipmap) const;
+	TextureLayout getLayout() const;
+	Uint32 sample(float u, float v, const ColorBuffer* mipmap) const;
+	void setLayout(TextureLayout layout);
+
+	/**
+	 * Samples a mipmap at wrapped UV coordinates without checking
+	 * whether the texture has any mipmaps, or whether the texel
+	 * is in bounds, which the mipmap's guard texels allow for.
+	 */
+	inline Uint32 sampleUnchecked(float u, float v, const ColorBuffer* mipmap) const {
+		u = wrap(u);
+		v = wrap(v);
+
+		return mipmap->readUnchecked((int)(u * mipmap->width), (int)(v * mipmap->height));
+	}
+
+	/**
+	 * Determines whether an alpha-tested mipmap is opaque at wrapped
+	 * UV coordinates from its coverage mask, with the same wrapping
+	 * and lack of checks as sampleUnchecked().
+	 */
+	inline bool isOpaqueUnchecked(float u, float v, const ColorBuffer* mipmap) const {
+		u = wrap(u);
+		v = wrap(v);
+
+		return mipmap->isOpaqueUnchecked((int)(u * mipmap->width), (int)(v * mipmap->height));
+	}
+
+	/**
+	 * Samples a mipmap of a texture with power-of-two dimensions
+	 * at fixed point texel coordinates, wrapping them with bitmasks
+	 * rather than branches. Coordinates may be negative, in which
+	 * case the arithmetic shift still rounds them down.
+	 */
+	inline Uint32 samplePowerOfTwoUnchecked(int u, int v, const ColorBuffer* mipmap) const {
+		int x = (u >> TEXEL_FIXED_POINT_SHIFT) & (mipmap->width - 1);
+		int y = (v >> TEXEL_FIXED_POINT_SHIFT) & (mipmap->height - 1);
+
+		return mipmap->readUnchecked(x, y);
+	}
 
 private:
 	bool isConfirmed = false;
 	const char* file;
-	std::vector<const ColorBuffer*> mipmaps;
+	std::vector<ColorBuffer*> mipmaps;
+	TextureLayout layout = TextureLayout::ROW_MAJOR;
 	SDL_Texture* texture = NULL;
 
+	void analyzeOpacity();
 	void savePixel(SDL_Surface* surface, int index);
+
+	/**
+	 * Modulo-free out-of-bounds UV wrapping.
+	 */
+	static inline float wrap(float t) {
+		if (t >= 1.0f) t -= (int)t;
+		else if (t < 0.0f) t += (int)(-1.0f * (t - 1.0f));
+
+		return t;
+	}
 };
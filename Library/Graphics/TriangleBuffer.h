@@ -1,6 +1,8 @@
 #pragma once
 
 #include <System/Geometry.h>
+#include <Constants.h>
+#include <atomic>
 #include <vector>
 
 class TriangleBuffer {
@@ -12,16 +14,41 @@ public:
 	const std::vector<Triangle*>& getBufferedTriangles();
 	int getTotalRequestedTriangles();
 	int getTotalNonStaticTriangles();
-	Triangle* requestTriangle();
+	Triangle* requestTriangle(int subPoolIndex = 0);
 	void reset();
 	void resetAll();
+	void setTotalSubPools(int totalSubPools, int expectedTriangles);
 
 private:
+	/**
+	 * SubPool
+	 * -------
+	 *
+	 * A contiguous slice of the active Triangle pool, allowing
+	 * multiple threads to request Triangles without contention.
+	 * Once its own slice is used up, Triangles are requested from
+	 * chunks claimed from the shared overflow instead. Aligned to
+	 * a cache line so that threads incrementing their own counters
+	 * don't invalidate one another's.
+	 */
+	struct alignas(64) SubPool {
+		int offset = 0;
+		int size = TRIANGLE_POOL_SIZE;
+		int next = 0;
+		int end = TRIANGLE_POOL_SIZE;
+		int totalRequestedTriangles = 0;
+	};
+
 	bool isSwapped = false;
-	int totalRequestedTriangles = 0;
+	std::vector<SubPool> subPools;
+	int totalSubPools = 1;
+	int subPoolSize = TRIANGLE_POOL_SIZE;
+	alignas(64) std::atomic<int> overflowOffset;
 
 	std::vector<Triangle*> triangleBufferA;
 	std::vector<Triangle*> triangleBufferB;
 	Triangle* trianglePoolA;
 	Triangle* trianglePoolB;
+
+	void resetSubPools();
 };
@@ -4,10 +4,10 @@
 #include <math.h>
 #include <SDL.h>
 
-#define FAST_CLAMP(v, l, h) (v < l ? l : v > h ? h : v)
-#define FAST_MAX(v1, v2) (v1 > v2 ? v1 : v2)
-#define FAST_MIN(v1, v2) (v1 < v2 ? v1 : v2)
-#define ARGB(r, g, b) (255 << 24) | (r << 16) | (g << 8) | b
+#define FAST_CLAMP(v, l, h) ((v) < (l) ? (l) : (v) > (h) ? (h) : (v))
+#define FAST_MAX(v1, v2) ((v1) > (v2) ? (v1) : (v2))
+#define FAST_MIN(v1, v2) ((v1) < (v2) ? (v1) : (v2))
+#define ARGB(r, g, b) ((255 << 24) | ((r) << 16) | ((g) << 8) | (b))
 
 namespace Lerp {
 	inline int lerp(int v1, int v2, float ratio) {
@@ -15,6 +15,7 @@ public:
 
 	void enterScene(Scene* scene);
 	void exitScene();
+	int getDrawTime();
 	int getFlags();
 	Coordinate getMousePosition();
 	int getWindowHeight();
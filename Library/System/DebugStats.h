@@ -24,6 +24,8 @@ public:
 	int getUpdateTime();
 	int getFrameTime();
 	int getFPS();
+	int getFrameAllocations();
+	int getScreenProjectionAllocations();
 	void countPolygons(int polygons);
 	void countVertices(int vertices);
 	int getTotalPolygons(const std::vector<Object*>& objects);
@@ -37,6 +39,8 @@ private:
 	Range<int> drawTime;
 	Range<int> updateTime;
 	Range<int> frameTime;
+	Range<int> screenProjectionAllocations;
+	Range<int> frameAllocations;
 
 	int totalPolygons = 0;
 	int totalVertices = 0;
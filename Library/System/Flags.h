@@ -11,5 +11,10 @@ enum Flags {
 	PIXEL_FILTER = 1 << 3,
 	DISABLE_MULTITHREADING = 1 << 4,
 	DISABLE_WINDOW_RESIZE = 1 << 5,
-	FPS_30 = 1 << 6
+	FPS_30 = 1 << 6,
+	TILE_RASTERIZATION = 1 << 7,
+	VISIBILITY_BUFFER = 1 << 8,
+	SPAN_BUFFER_RASTERIZATION = 1 << 9,
+	DEPTH_EPOCHS = 1 << 10,
+	DYNAMIC_RESOLUTION = 1 << 11
 };
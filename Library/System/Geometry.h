@@ -35,13 +35,29 @@ struct Vertex3d : Colorable {
 	std::vector<Polygon*> connectedPolygons;
 	std::vector<Vec3> morphTargets;
 
-	static Vertex3d lerp(const Vertex3d& v1, const Vertex3d& v2, float r);
 	void morph(int startTarget, int endTarget, float progress);
 	void rotate(const RotationMatrix& rotationMatrix);
 	void scale(float scalar);
 	void scale(const Vec3& scaleVector);
 };
 
+/**
+ * ViewVertex
+ * ----------
+ *
+ * A vertex transformed into camera view space for projection,
+ * holding only the attributes needed to project and shade it.
+ * Unlike Vertex3d, it owns no heap storage, so it can be copied
+ * and interpolated during projection without allocating.
+ */
+struct ViewVertex : Colorable {
+	Vec3 vector;
+	Vec3 normal;
+	Vec2 uv;
+
+	static ViewVertex lerp(const ViewVertex& v1, const ViewVertex& v2, float r);
+};
+
 /**
  * Triangle
  * --------
@@ -87,6 +103,15 @@ struct Bounds {
 	bool isColliding(const Bounds& bounds) const;
 };
 
+/**
+ * BoundingSphere
+ * --------------
+ */
+struct BoundingSphere {
+	Vec3 center;
+	float radius = 0.0f;
+};
+
 /**
  * Sector
  * ------
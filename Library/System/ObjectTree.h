@@ -0,0 +1,83 @@
+#pragma once
+
+#include <System/Objects.h>
+#include <System/Geometry.h>
+#include <System/Math.h>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * BoundsPredicate
+ * ---------------
+ */
+typedef std::function<bool(const Bounds&)> BoundsPredicate;
+
+/**
+ * RayHitHandler
+ * -------------
+ *
+ * Determines the distance along a ray at which it hits an Object,
+ * or a negative distance if it misses the Object.
+ */
+typedef std::function<float(const Object*)> RayHitHandler;
+
+/**
+ * ObjectTree
+ * ----------
+ */
+class ObjectTree {
+public:
+	void clear();
+	const Bounds& getBounds(const Object* object) const;
+	bool has(const Object* object) const;
+	void insert(Object* object, const Bounds& bounds);
+	void query(const BoundsPredicate& isOverlapping, std::vector<Object*>& objects, bool isOrdered);
+	Object* raycast(const Vec3& origin, const Vec3& direction, const RayHitHandler& getHitDistance);
+	void remove(const Object* object);
+	bool update(const Object* object, const Bounds& bounds);
+
+private:
+	/**
+	 * Node
+	 * ----
+	 *
+	 * A node in the tree, either a leaf holding an Object, or a
+	 * branch with two children. Leaf bounds are expanded by a
+	 * margin so that Objects can move slightly without having
+	 * to be reinserted, and branch bounds enclose both children.
+	 * Height is the length of the longest path down to a leaf.
+	 */
+	struct Node {
+		Bounds bounds;
+		Object* object = NULL;
+		int sequence = 0;
+		int height = 0;
+		int parent = -1;
+		int children[2] = { -1, -1 };
+
+		bool isLeaf() const;
+	};
+
+	std::vector<Node> nodes;
+	std::vector<int> freeNodes;
+	std::unordered_map<const Object*, int> leaves;
+	std::vector<int> stack;
+	std::vector<std::pair<int, Object*>> results;
+	int root = -1;
+	int nextSequence = 0;
+
+	static Bounds combine(const Bounds& a, const Bounds& b);
+	static bool contains(const Bounds& outer, const Bounds& inner);
+	static Bounds expand(const Bounds& bounds, float margin);
+	static float getSurfaceArea(const Bounds& bounds);
+	static float getRayEntryDistance(const Bounds& bounds, const Vec3& origin, const Vec3& inverseDirection);
+
+	int allocateNode();
+	int balance(int index);
+	void freeNode(int index);
+	void insertLeaf(int leaf);
+	void refitAncestors(int index);
+	void removeLeaf(int leaf);
+};
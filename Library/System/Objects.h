@@ -17,6 +17,8 @@
  */
 typedef std::function<void(int)> UpdateHandler;
 
+struct Light;
+
 /**
  * Object
  * ------
@@ -52,8 +54,13 @@ struct Object : public Positionable3d {
 
 	void addLOD(Object* lod);
 	void addMorphTarget(Object* morphTarget);
+	void addNearbyLight(Light* light);
+	void clearNearbyLights();
 	const Object* getLOD(float distance) const;
+	const Bounds& getBounds() const;
+	const BoundingSphere& getBoundingSphere() const;
 	const std::vector<Object*>& getLODs() const;
+	const std::vector<Light*>& getNearbyLights() const;
 	int getPolygonCount() const;
 	const std::vector<Polygon*>& getPolygons() const;
 	int getVertexCount() const;
@@ -89,6 +96,7 @@ protected:
 	void addVertex(const Vec3& vector);
 	void addVertex(const Vec3& vector, const Color& color);
 	void addVertex(const Vec3& vector, const Vec2& uv);
+	void updateBounds();
 
 private:
 	struct Morph {
@@ -101,6 +109,9 @@ private:
 
 	std::vector<Polygon*> polygons;
 	std::vector<Object*> lods;
+	std::vector<Light*> nearbyLights;
+	Bounds bounds;
+	BoundingSphere boundingSphere;
 	Morph morph;
 	int totalMorphTargets = 0;
 
@@ -179,6 +190,8 @@ private:
 struct Skybox : Object {
 	Skybox(float size);
 
+	RotationMatrix getInverseRotationMatrix() const;
+	float getSize() const;
 	void setTexture(TextureBuffer* texture);
 
 private:
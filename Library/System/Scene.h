@@ -7,6 +7,7 @@
 #include <Sound/Sound.h>
 #include <System/Objects.h>
 #include <System/Geometry.h>
+#include <System/ObjectTree.h>
 #include <System/ParticleSystem.h>
 #include <System/Camera.h>
 #include <UI/UI.h>
@@ -34,8 +35,10 @@ struct Settings {
 	Vec3 ambientLightVector = { 0, -1, 0 };
 	float ambientLightFactor = 1.0f;
 	bool hasStaticAmbientLight = false;
+	bool hasOpaqueBackground = false;
 	float brightness = 1.0f;
 	int visibility = INT_MAX;
+	int perspectiveSpanLength = 0;
 	int controlMode = ControlMode::WASD | ControlMode::MOUSE;
 };
 
@@ -56,17 +59,22 @@ public:
 	const Camera& getCamera() const;
 	const std::vector<Light*>& getLights();
 	const std::vector<Object*>& getObjects();
+	const Skybox* getSkybox() const;
 	const std::vector<Sound*>& getSounds();
 	bool isInCurrentOccupiedSector(int sectorId);
 	virtual void load() = 0;
 	virtual void onStart();
 	virtual void onUpdate(int dt);
+	Object* pickObject(const Vec3& origin, const Vec3& direction);
+	Object* pickObjectInView();
 	void provideController(Controller* controller);
 	void provideUI(UI* ui);
+	void queryObjects(const BoundsPredicate& isOverlapping, std::vector<Object*>& objects);
 	void resume();
 	void suspend();
 	void togglePause();
 	void update(int dt);
+	void updateObjectTree();
 
 protected:
 	Controller* controller = NULL;
@@ -94,6 +102,13 @@ private:
 	std::vector<Light*> lights;
 	std::vector<Sound*> sounds;
 	std::vector<Sector> sectors;
+	Skybox* skybox = NULL;
+	ObjectTree objectTree;
+	std::vector<Object*> overlappingObjects;
+	std::vector<std::pair<Object*, Bounds>> reinsertedObjects;
+	std::vector<Object*> addedObjects;
+	std::vector<Object*> relitObjects;
+	std::vector<Bounds> assignedLightBounds;
 	std::map<const char*, Object*> objectMap;
 	std::map<const char*, ObjLoader*> objLoaderMap;
 	std::map<const char*, TextureBuffer*> textureBufferMap;
@@ -107,12 +122,17 @@ private:
 	int runningTime = 0;
 	bool isPaused = false;
 	bool shouldReset = false;
+	bool shouldReassignLights = true;
 
+	void assignNearbyLights();
 	void boot();
 	void emptyDisposalQueues();
+	Bounds getLightBounds(const Light* light);
+	Bounds getObjectBounds(const Object* object);
 	void handleControl(int dt);
 	void handleMouseMotion(int dx, int dy);
 	void handleWASDControl(int dt);
+	void reassignNearbyLights(Object* object);
 	void removeExpiredObjects();
 	void removeObject(Object* object);
 
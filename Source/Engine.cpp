@@ -81,6 +81,8 @@ Engine::Engine(int width, int height, const char* title, const char* iconPath, c
 
 	this->flags = flags;
 
+	projectionSections.resize(1);
+
 	resizeRasterRegion();
 
 	if (~flags & DISABLE_MULTITHREADING) {
@@ -97,6 +99,10 @@ Engine::~Engine() {
 		SDL_WaitThread(renderThread, NULL);
 	}
 
+	for (int i = 1; i < (int)projectionSections.size(); i++) {
+		delete projectionSections[i].rasterFilter;
+	}
+
 	delete triangleBuffer;
 	delete illuminator;
 	delete rasterFilter;
@@ -128,6 +134,28 @@ void Engine::awaitRenderStep(RenderStep renderStep) {
 	}
 }
 
+/**
+ * Projects the current frame's queued polygons in parallel, with
+ * the main thread projecting the first section and each render
+ * worker projecting one of the others. Render workers project
+ * sections independently of the render step they are signaled
+ * for by the render thread, so screen projection can still occur
+ * while the previous frame is rendered.
+ */
+void Engine::awaitScreenProjection(int totalSections) {
+	for (int i = 0; i < totalSections - 1; i++) {
+		renderWorkerManagers[i].isProjecting = true;
+	}
+
+	projectSection(0);
+
+	for (int i = 0; i < totalSections - 1; i++) {
+		while (renderWorkerManagers[i].isProjecting) {
+			SDL_Delay(1);
+		}
+	}
+}
+
 void Engine::createRenderThreads() {
 	// Adhering to a 1-active-thread-per-core limit, we can allot
 	// as many render worker threads as cores are available after
@@ -142,6 +170,14 @@ void Engine::createRenderThreads() {
 
 	renderWorkerManagers = new RenderWorkerManager[totalRenderWorkerThreads];
 
+	// Each render worker can project its own section of the scene,
+	// in addition to the section projected by the main thread
+	projectionSections.resize(totalRenderWorkerThreads + 1);
+
+	for (int i = 1; i < (int)projectionSections.size(); i++) {
+		projectionSections[i].rasterFilter = new RasterFilter(maxRasterArea.width, maxRasterArea.height);
+	}
+
 	// Create render worker threads
 	for (int i = 0; i < totalRenderWorkerThreads; i++) {
 		RenderWorkerManager* manager = &renderWorkerManagers[i];
@@ -157,6 +193,15 @@ void Engine::createRenderThreads() {
 	renderThread = SDL_CreateThread(Engine::handleRenderThread, NULL, this);
 }
 
+/**
+ * Returns the time spent rasterizing the most recently drawn frame,
+ * which unlike the total frame time isn't held to the display's
+ * refresh interval by vsync.
+ */
+int Engine::getDrawTime() {
+	return debugStats.getDrawTime();
+}
+
 int Engine::getFlags() {
 	return flags;
 }
@@ -174,7 +219,9 @@ int Engine::getWindowWidth() {
  * the rendering pipeline, render workers either handle illumination
  * or scanline rasterization in parallel with one another, each
  * managing an isolated set of triangles (for illumination) or
- * scanlines (for rasterization) to avoid race conditions.
+ * screen bands (for rasterization) to avoid race conditions.
+ * Render workers also project their own sections of the next
+ * frame when signaled to by the main thread.
  */
 int Engine::handleRenderWorkerThread(void* data) {
 	SDL_SetThreadPriority(SDL_THREAD_PRIORITY_TIME_CRITICAL);
@@ -207,14 +254,12 @@ int Engine::handleRenderWorkerThread(void* data) {
 					break;
 				}
 				case RenderStep::SCANLINE_RASTERIZATION: {
-					for (int i = 0; i < currentRasterizer->getTotalBufferedScanlines(); i++) {
-						const Scanline* scanline = currentRasterizer->getScanline(i);
-
-						// Each render worker rasterizes scanlines on every Nth screen row,
-						// where N is the number of available workers.
-						if (scanline->y % totalRenderWorkerThreads == manager->sectionId) {
-							currentRasterizer->triangleScanline(scanline);
-						}
+					for (int i = manager->sectionId; i < currentRasterizer->getTotalBands(); i += totalRenderWorkerThreads) {
+						// Each render worker rasterizes every Nth band of screen rows,
+						// where N is the number of available workers. Scanlines are
+						// pre-binned by band, so workers only read their own Scanlines
+						// and only write to their own contiguous regions of the screen.
+						currentRasterizer->rasterizeBand(i);
 					}
 
 					break;
@@ -226,6 +271,12 @@ int Engine::handleRenderWorkerThread(void* data) {
 			manager->isWorking = false;
 		}
 
+		if (manager->isProjecting) {
+			engine->projectSection(manager->sectionId + 1);
+
+			manager->isProjecting = false;
+		}
+
 		SDL_Delay(1);
 	}
 
@@ -306,6 +357,50 @@ void Engine::initialize() {
 	SDL_SetRelativeMouseMode(SDL_TRUE);
 }
 
+bool Engine::isObjectCulled(const Object* object, const Vec3& relativeObjectPosition) {
+	const BoundingSphere& boundingSphere = object->getBoundingSphere();
+
+	return isSphereCulled(cameraRotationMatrix * (relativeObjectPosition + boundingSphere.center), boundingSphere.radius);
+}
+
+/**
+ * Determines whether a sphere, centered at a view space position,
+ * lies entirely outside one side of the viewing frustum, in which
+ * case every polygon within it would be culled anyway. The sides
+ * match those tested per vertex by FrustumOutcode: the near and
+ * far sides are depth thresholds, while the left, right, top and
+ * bottom sides are cones around the view space axes, which a
+ * vertex lies within when its unit vector component exceeds
+ * the field of view's half-angle sine.
+ */
+bool Engine::isSphereCulled(const Vec3& center, float radius) {
+	if (center.z + radius < NEAR_PLANE_DISTANCE || center.z - radius > activeScene->settings.visibility) {
+		return true;
+	}
+
+	float distanceSquared = Vec3::dotProduct(center, center);
+	float radiusSquared = radius * radius;
+	float fovAngleCosine = sqrtf(1.0f - fovAngleRange * fovAngleRange);
+
+	if (distanceSquared <= radiusSquared || radiusSquared >= fovAngleCosine * fovAngleCosine * distanceSquared) {
+		// The sphere either contains the camera or spans too
+		// wide an angle to fit within any of the side cones
+		return false;
+	}
+
+	// A sphere fits within a side cone when the angle between its
+	// center and the cone axis, plus its own angular radius, is
+	// smaller than the cone's half-angle. Comparing the cosines
+	// of those angles leaves the following threshold, which the
+	// sphere center's component along the cone axis must exceed.
+	float threshold = fovAngleRange * sqrtf(distanceSquared - radiusSquared) + fovAngleCosine * radius;
+
+	return (
+		-center.x > threshold || center.x > threshold ||
+		-center.y > threshold || center.y > threshold
+	);
+}
+
 void Engine::lockProportionalRasterRegion(int xp, int yp, int wp, int hp) {
 	rasterLockRegion.x = xp;
 	rasterLockRegion.y = yp;
@@ -347,9 +442,12 @@ void Engine::precomputeStaticLightColorIntensities() {
  * polygon, as well as additional values to aid with lighting
  * and scaling calculations. For efficiency we forward the
  * arguments from drawScene(), which has already computed them.
+ * The triangle is requested from and queued into the buffers
+ * belonging to the projection section it was projected for.
  */
 void Engine::projectAndQueueTriangle(
-	const Vertex3d (&vertexes)[3],
+	int sectionIndex,
+	const ViewVertex (&vertexes)[3],
 	const Vec3 (&unitVecs)[3],
 	const Vec3 (&worldVecs)[3],
 	const Polygon* sourcePolygon,
@@ -358,15 +456,15 @@ void Engine::projectAndQueueTriangle(
 	bool isSynthetic
 ) {
 	float objectFresnelFactor = sourcePolygon->sourceObject->fresnelFactor;
-	Triangle* triangle = triangleBuffer->requestTriangle();
+	Triangle* triangle = triangleBuffer->requestTriangle(sectionIndex);
 
 	triangle->sourcePolygon = const_cast<Polygon*>(sourcePolygon);
 	triangle->isSynthetic = isSynthetic;
 	triangle->fresnelFactor = objectFresnelFactor > 0 ? cosf(normalizedDotProduct * (M_PI / 2.0f)) * objectFresnelFactor : 0.0f;
 
 	for (int i = 0; i < 3; i++) {
-		const Vertex3d& vertex3d = vertexes[i];
-		const Vec3& vector = vertex3d.vector;
+		const ViewVertex& viewVertex = vertexes[i];
+		const Vec3& vector = viewVertex.vector;
 		const Vec3& unit = unitVecs[i];
 		float inverseDepth = 1.0f / vector.z;
 
@@ -376,13 +474,224 @@ void Engine::projectAndQueueTriangle(
 		vertex->coordinate.y = (int)(scale * -unit.y / unit.z + halfRasterArea.height);
 		vertex->z = vector.z;
 		vertex->inverseDepth = inverseDepth;
-		vertex->perspectiveUV = vertex3d.uv * inverseDepth;
-		vertex->color = vertex3d.color;
+		vertex->perspectiveUV = viewVertex.uv * inverseDepth;
+		vertex->color = viewVertex.color;
 		vertex->worldVector = worldVecs[i];
-		vertex->normal = vertex3d.normal;
+		vertex->normal = viewVertex.normal;
 	}
 
-	rasterFilter->addTriangle(triangle);
+	projectionSections[sectionIndex].rasterFilter->addTriangle(triangle);
+}
+
+/**
+ * Projects the polygons in one section of the current frame's
+ * queued Objects, buffering the resulting Triangles into the
+ * section's own RasterFilter. Sections may be projected in
+ * parallel, since they share no mutable state.
+ */
+void Engine::projectSection(int sectionIndex) {
+	ProjectionSection& section = projectionSections[sectionIndex];
+	const Vec3& cameraPosition = activeScene->getCamera().position;
+	const ViewSpaceCache& viewSpaceCache = section.viewSpaceCache;
+
+	// Allocate reusable vertex/vector objects up front to
+	// be overwritten/projected with each subsequent polygon.
+	// View vertices only copy the attributes needed for
+	// projection, so no heap storage is copied with them.
+	ViewVertex t_verts[3];
+	Vec3 u_vecs[3];
+	Vec3 w_vecs[3];
+
+	for (const auto& projectedObject : projectedObjects) {
+		const Object* object = projectedObject.object;
+		const Object* lodObject = projectedObject.lodObject;
+		const std::vector<Polygon*>& polygons = lodObject->getPolygons();
+		int start = max(section.start - projectedObject.polygonOffset, 0);
+		int end = min(section.end - projectedObject.polygonOffset, (int)polygons.size());
+
+		if (start >= end) {
+			continue;
+		}
+
+		Vec3 relativeObjectPosition = object->position - cameraPosition;
+		const Vertex3d* vertices = lodObject->getVertices().data();
+		int firstVertex = 0;
+		int endVertex = lodObject->getVertexCount();
+
+		if (end - start < (int)polygons.size()) {
+			// Objects split across sections only have the range
+			// of vertices used by this section's polygons transformed
+			firstVertex = endVertex;
+			endVertex = 0;
+
+			for (int p = start; p < end; p++) {
+				for (int i = 0; i < 3; i++) {
+					int index = (int)(polygons[p]->vertices[i] - vertices);
+
+					firstVertex = min(firstVertex, index);
+					endVertex = max(endVertex, index + 1);
+				}
+			}
+		}
+
+		updateViewSpaceCache(section.viewSpaceCache, lodObject, relativeObjectPosition, firstVertex, endVertex);
+
+		for (int p = start; p < end; p++) {
+			const Polygon* polygon = polygons[p];
+
+			Vec3 relativePolygonPosition = relativeObjectPosition + polygon->vertices[0]->vector;
+			float normalizedDotProduct = Vec3::dotProduct(polygon->normal, relativePolygonPosition.unit());
+
+			// As hack to fix polygons viewed at or near glancing angles
+			// being rendered as holes in meshes, we allow polygons through
+			// even when they are very marginally back-facing.
+			bool isFacingCamera = normalizedDotProduct < 0.05f;
+
+			if (!isFacingCamera) {
+				continue;
+			}
+
+			int indexes[3];
+
+			for (int i = 0; i < 3; i++) {
+				indexes[i] = (int)(polygon->vertices[i] - vertices);
+			}
+
+			const int* outcodes = viewSpaceCache.outcodes.data();
+
+			if ((outcodes[indexes[0]] & outcodes[indexes[1]] & outcodes[indexes[2]]) != 0) {
+				continue;
+			}
+
+			int totalNearVertices = 0;
+
+			// Assemble our vertex/unit + world vector lists from
+			// the vertices already transformed into view space
+			for (int i = 0; i < 3; i++) {
+				const Vertex3d* vertex = polygon->vertices[i];
+				int index = indexes[i];
+
+				t_verts[i].vector = viewSpaceCache.vectors[index];
+				t_verts[i].normal = vertex->normal;
+				t_verts[i].uv = vertex->uv;
+				t_verts[i].color = vertex->color;
+				u_vecs[i] = viewSpaceCache.unitVectors[index];
+				w_vecs[i] = object->position + vertex->vector;
+
+				if (outcodes[index] & FrustumOutcode::FRUSTUM_NEAR) {
+					totalNearVertices++;
+				}
+			}
+
+			if (totalNearVertices > 0) {
+				// If any vertices are behind the near plane, we have to
+				// clip them against it. This is necessary to prevent
+				// erroneous screen projections at coordinates <= 0.
+
+				// Sort vertices by descending z-order so we can determine
+				// where to interpolate the clipped vertices
+				if (t_verts[0].vector.z < t_verts[1].vector.z) {
+					swap(t_verts[0], t_verts[1]);
+					swap(u_vecs[0], u_vecs[1]);
+					swap(w_vecs[0], w_vecs[1]);
+				}
+
+				if (t_verts[1].vector.z < t_verts[2].vector.z) {
+					swap(t_verts[1], t_verts[2]);
+					swap(u_vecs[1], u_vecs[2]);
+					swap(w_vecs[1], w_vecs[2]);
+				}
+
+				if (t_verts[0].vector.z < t_verts[1].vector.z) {
+					swap(t_verts[0], t_verts[1]);
+					swap(u_vecs[0], u_vecs[1]);
+					swap(w_vecs[0], w_vecs[1]);
+				}
+
+				if (totalNearVertices == 2) {
+					// When two of the polygon's vertices are behind the near
+					// plane, it can be clipped into a smaller polygon at the
+					// plane boundary.
+
+					// Determine interpolation deltas for each new vertex
+					// (the first need not be interpolated at all)
+					float deltas[3] = {
+						0.0f,
+						(t_verts[0].vector.z - object->nearClippingDistance) / (t_verts[0].vector.z - t_verts[1].vector.z),
+						(t_verts[0].vector.z - object->nearClippingDistance) / (t_verts[0].vector.z - t_verts[2].vector.z)
+					};
+
+					// Generate new vertices and unit/world vectors for the clipped polygon
+					for (int i = 1; i < 3; i++) {
+						t_verts[i] = ViewVertex::lerp(t_verts[0], t_verts[i], deltas[i]);
+						u_vecs[i] = t_verts[i].vector.unit();
+						w_vecs[i] = Vec3::lerp(w_vecs[0], w_vecs[i], deltas[i]);
+					}
+
+					// Project the clipped polygon
+					projectAndQueueTriangle(
+						sectionIndex,
+						t_verts, u_vecs, w_vecs,
+						polygon, normalizedDotProduct, projectionScale, true
+					);
+				} else if (totalNearVertices == 1) {
+					// If only one of the polygon's vertices is behind the
+					// near plane, we need to clip it into a quad, which then
+					// needs to be clipped into two polygons. The first and
+					// second vertices can be preserved, whereas the latter
+					// two will have to be interpolated between the second and
+					// third, and first and third original vertices.
+					ViewVertex quadVerts[4];
+					Vec3 u_quadVecs[4];
+					Vec3 w_quadVecs[4];
+
+					// Determine interpolation deltas for third and fourth vertices
+					float v2Delta = (t_verts[1].vector.z - object->nearClippingDistance) / (t_verts[1].vector.z - t_verts[2].vector.z);
+					float v3Delta = (t_verts[0].vector.z - object->nearClippingDistance) / (t_verts[0].vector.z - t_verts[2].vector.z);
+
+					// Define new vertices + unit/world vectors for the quad
+					quadVerts[0] = t_verts[0];
+					quadVerts[1] = t_verts[1];
+					quadVerts[2] = ViewVertex::lerp(t_verts[1], t_verts[2], v2Delta);
+					quadVerts[3] = ViewVertex::lerp(t_verts[0], t_verts[2], v3Delta);
+
+					u_quadVecs[0] = quadVerts[0].vector.unit();
+					u_quadVecs[1] = quadVerts[1].vector.unit();
+					u_quadVecs[2] = quadVerts[2].vector.unit();
+					u_quadVecs[3] = quadVerts[3].vector.unit();
+
+					w_quadVecs[0] = w_vecs[0];
+					w_quadVecs[1] = w_vecs[1];
+					w_quadVecs[2] = Vec3::lerp(w_vecs[1], w_vecs[2], v2Delta);
+					w_quadVecs[3] = Vec3::lerp(w_vecs[0], w_vecs[2], v3Delta);
+
+					// Project the quad's two polygons individually
+					projectAndQueueTriangle(
+						sectionIndex,
+						{ quadVerts[0], quadVerts[1], quadVerts[2] },
+						{ u_quadVecs[0], u_quadVecs[1], u_quadVecs[2] },
+						{ w_quadVecs[0], w_quadVecs[1], w_quadVecs[2] },
+						polygon, normalizedDotProduct, projectionScale, true
+					);
+
+					projectAndQueueTriangle(
+						sectionIndex,
+						{ quadVerts[0], quadVerts[2], quadVerts[3] },
+						{ u_quadVecs[0], u_quadVecs[2], u_quadVecs[3] },
+						{ w_quadVecs[0], w_quadVecs[2], w_quadVecs[3] },
+						polygon, normalizedDotProduct, projectionScale, true
+					);
+				}
+			} else {
+				// Project a regular, unclipped triangle
+				projectAndQueueTriangle(
+					sectionIndex,
+					t_verts, u_vecs, w_vecs,
+					polygon, normalizedDotProduct, projectionScale, false
+				);
+			}
+		}
+	}
 }
 
 void Engine::resizeRasterRegion() {
@@ -395,6 +704,9 @@ void Engine::resizeRasterRegion() {
 	int rasterWidth = hasPixelFilter ? rasterRegion.width / 2 : rasterRegion.width;
 	int rasterHeight = hasPixelFilter ? rasterRegion.height / 2 : rasterRegion.height;
 
+	maxRasterArea.width = rasterWidth;
+	maxRasterArea.height = rasterHeight;
+	rasterArea = maxRasterArea;
 	halfRasterArea.width = (int)(rasterWidth / 2);
 	halfRasterArea.height = (int)(rasterHeight / 2);
 
@@ -409,6 +721,16 @@ void Engine::resizeRasterRegion() {
 	rasterizer = new Rasterizer(renderer, rasterWidth, rasterHeight);
 	rasterFilter = new RasterFilter(rasterWidth, rasterHeight);
 
+	// The first projection section queues directly into the main
+	// raster filter, which the other sections are merged into
+	projectionSections[0].rasterFilter = rasterFilter;
+
+	for (int i = 1; i < (int)projectionSections.size(); i++) {
+		delete projectionSections[i].rasterFilter;
+
+		projectionSections[i].rasterFilter = new RasterFilter(rasterWidth, rasterHeight);
+	}
+
 	rasterizer->setOffset({ rasterRegion.x, rasterRegion.y });
 }
 
@@ -428,6 +750,7 @@ void Engine::setActiveScene(Scene* scene) {
 		scene->hasInitialized = true;
 	}
 
+	activeScene->updateObjectTree();
 	updateSounds();
 	precomputeStaticLightColorIntensities();
 
@@ -465,9 +788,19 @@ void Engine::update(int dt) {
 
 	// Update view
 	SDL_RenderClear(renderer);
+	updateRasterArea();
 
 	rasterizer->setBackgroundColor(settings.backgroundColor);
+	rasterizer->setBackgroundCovered(settings.hasOpaqueBackground && !(flags & SHOW_WIREFRAME));
+	rasterizer->setDepthEpochs(flags & DEPTH_EPOCHS);
 	rasterizer->setVisibility(settings.visibility);
+	rasterizer->setPerspectiveSpanLength(settings.perspectiveSpanLength);
+	rasterizer->setRasterMode((flags & TILE_RASTERIZATION) ? RasterMode::TILE : RasterMode::SCANLINE);
+	rasterizer->setShadingMode(
+		(flags & SPAN_BUFFER_RASTERIZATION) ? ShadingMode::SPAN_BUFFER :
+		(flags & VISIBILITY_BUFFER) ? ShadingMode::DEFERRED :
+		ShadingMode::FORWARD
+	);
 	rasterizer->clear();
 
 	updateSounds();
@@ -508,6 +841,7 @@ void Engine::update(int dt) {
 	// Advance game logic
 	debugStats.trackUpdateTime();
 	activeScene->update(dt);
+	activeScene->updateObjectTree();
 	debugStats.logUpdateTime();
 
 	// Frame lock checks, debug stat updates, render to screen
@@ -549,6 +883,50 @@ void Engine::toggleFlag(Flags flag) {
 		case DISABLE_WINDOW_RESIZE:
 			SDL_SetWindowResizable(window, (flags & DISABLE_WINDOW_RESIZE) ? SDL_FALSE : SDL_TRUE);
 			break;
+		default:
+			// Other flags are read as needed each frame
+			break;
+	}
+}
+
+/**
+ * Picks the raster area to project the next frame into. With dynamic
+ * resolution enabled, the raster area shrinks by a small step whenever
+ * the last frame's illumination and draw time went over the frame time
+ * budget, and grows back once there is comfortable headroom again,
+ * trading sharpness for a steady frame rate in heavy scenes.
+ */
+void Engine::updateRasterArea() {
+	if (flags & DYNAMIC_RESOLUTION) {
+		int frameTimeBudget = (flags & FPS_30) ? 2 * DYNAMIC_RESOLUTION_FRAME_TIME : DYNAMIC_RESOLUTION_FRAME_TIME;
+		int renderTime = debugStats.getIlluminationTime() + debugStats.getDrawTime();
+
+		if (renderTime > frameTimeBudget) {
+			rasterScale = max(rasterScale - DYNAMIC_RESOLUTION_SCALE_STEP, MIN_DYNAMIC_RESOLUTION_SCALE);
+		} else if (renderTime < frameTimeBudget * 3 / 4) {
+			rasterScale = min(rasterScale + DYNAMIC_RESOLUTION_SCALE_STEP, 100);
+		}
+	} else {
+		rasterScale = 100;
+	}
+
+	Area previousRasterArea = rasterArea;
+
+	rasterArea.width = maxRasterArea.width * rasterScale / 100;
+	rasterArea.height = maxRasterArea.height * rasterScale / 100;
+	halfRasterArea.width = (int)(rasterArea.width / 2);
+	halfRasterArea.height = (int)(rasterArea.height / 2);
+
+	// In multithreaded mode, the frame rasterized during this update
+	// was projected during the previous one, so it has to be rendered
+	// at the previous raster area
+	bool isPipelined = renderWorkerThreads.size() > 0 && !(flags & SHOW_WIREFRAME);
+	const Area& renderArea = isPipelined ? previousRasterArea : rasterArea;
+
+	rasterizer->setResolution(renderArea.width, renderArea.height);
+
+	for (auto& section : projectionSections) {
+		section.rasterFilter->setResolution(rasterArea.width, rasterArea.height);
 	}
 }
 
@@ -565,9 +943,16 @@ void Engine::updateScene_MultiThreaded() {
 		// Signal the main render thread to kick off the
 		// rendering pipeline while we perform screen
 		// projection/raster filtering here
+		rasterizer->setSkyboxView(skyboxView);
+
 		isRendering = true;
 	}
 
+	// The previous frame was finished rasterizing into its own
+	// framebuffer during the last update, so it can be presented
+	// while the render thread rasterizes the current one
+	rasterizer->renderPreviousFrame(renderer, (flags & PIXEL_FILTER) ? 2 : 1);
+
 	debugStats.trackScreenProjectionTime();
 
 	updateScreenProjection();
@@ -587,8 +972,6 @@ void Engine::updateScene_MultiThreaded() {
 		while (isRendering) {
 			SDL_Delay(1);
 		}
-
-		rasterizer->render(renderer, (flags & PIXEL_FILTER) ? 2 : 1);
 	}
 }
 
@@ -601,6 +984,8 @@ void Engine::updateScene_SingleThreaded() {
 
 	updateScreenProjection();
 
+	rasterizer->setSkyboxView(skyboxView);
+
 	debugStats.logScreenProjectionTime();
 	debugStats.trackHiddenSurfaceRemovalTime();
 
@@ -624,8 +1009,8 @@ void Engine::updateScene_SingleThreaded() {
 		rasterizer->dispatchTriangle(*triangle);
 	}
 
-	for (int i = 0; i < rasterizer->getTotalBufferedScanlines(); i++) {
-		rasterizer->triangleScanline(rasterizer->getScanline(i));
+	for (int i = 0; i < rasterizer->getTotalBands(); i++) {
+		rasterizer->rasterizeBand(i);
 	}
 
 	rasterizer->render(renderer, (flags & PIXEL_FILTER) ? 2 : 1);
@@ -641,6 +1026,8 @@ void Engine::updateScene_Wireframe() {
 
 	updateScreenProjection();
 
+	rasterizer->setSkyboxView(SkyboxView());
+
 	debugStats.logScreenProjectionTime();
 	debugStats.trackHiddenSurfaceRemovalTime();
 
@@ -655,6 +1042,12 @@ void Engine::updateScene_Wireframe() {
 	debugStats.logIlluminationTime();
 	debugStats.trackDrawTime();
 
+	// No triangles are dispatched in wireframe mode, but the screen
+	// is cleared one band at a time as bands are rasterized
+	for (int i = 0; i < rasterizer->getTotalBands(); i++) {
+		rasterizer->rasterizeBand(i);
+	}
+
 	for (auto* triangle : triangleBuffer->getBufferedTriangles()) {
 		rasterizer->triangle(
 			triangle->vertices[0].coordinate.x, triangle->vertices[0].coordinate.y,
@@ -669,181 +1062,100 @@ void Engine::updateScene_Wireframe() {
 
 void Engine::updateScreenProjection() {
 	const Camera& camera = activeScene->getCamera();
-	float projectionScale = (float)max(halfRasterArea.width, halfRasterArea.height) * (180.0f / camera.fov);
-	float fovAngleRange = sinf(DEG_TO_RAD * camera.fov / 2.0f);
-	RotationMatrix cameraRotationMatrix = camera.getRotationMatrix();
-
-	// Allocate reusable vertex/vector objects up front to
-	// be overwritten/projected with each subsequent polygon
-	Vertex3d t_verts[3];
-	Vec3 u_vecs[3];
-	Vec3 w_vecs[3];
+	const Skybox* skybox = activeScene->getSkybox();
 
-	for (const auto* object : activeScene->getObjects()) {
-		Vec3 relativeObjectPosition = object->position - camera.position;
-		const Object* lodObject = object->hasLODs() ? object->getLOD(relativeObjectPosition.magnitude()) : object;
+	projectionScale = (float)max(halfRasterArea.width, halfRasterArea.height) * (180.0f / camera.fov);
+	fovAngleRange = sinf(DEG_TO_RAD * camera.fov / 2.0f);
+	cameraRotationMatrix = camera.getRotationMatrix();
 
-		if (!activeScene->isInCurrentOccupiedSector(object->sectorId)) {
-			continue;
-		}
+	// Textured skyboxes aren't projected like other Objects; they're
+	// instead shaded into whichever pixels remain uncovered once the
+	// rest of the scene has been rasterized, sampled along the world
+	// space view direction through each pixel
+	skyboxView = SkyboxView();
 
-		debugStats.countPolygons(lodObject->getPolygonCount());
-		debugStats.countVertices(lodObject->getVertexCount());
-
-		if (lodObject->texture != NULL) {
-			lodObject->texture->confirmTexture(renderer, TextureMode::SOFTWARE);
-		}
-
-		for (const auto* polygon : lodObject->getPolygons()) {
-			Vec3 relativePolygonPosition = relativeObjectPosition + polygon->vertices[0]->vector;
-			float normalizedDotProduct = Vec3::dotProduct(polygon->normal, relativePolygonPosition.unit());
-
-			// As hack to fix polygons viewed at or near glancing angles
-			// being rendered as holes in meshes, we allow polygons through
-			// even when they are very marginally back-facing.
-			bool isFacingCamera = normalizedDotProduct < 0.05f;
+	if (skybox != NULL && skybox->texture != NULL) {
+		RotationMatrix skyboxRotationMatrix = skybox->getInverseRotationMatrix() * cameraRotationMatrix.transpose();
+		float inverseProjectionScale = 1.0f / projectionScale;
 
-			if (!isFacingCamera) {
-				continue;
-			}
+		skybox->texture->confirmTexture(renderer, TextureMode::SOFTWARE);
 
-			FrustumCuller frustumCuller;
+		skyboxView.texture = skybox->texture;
+		skyboxView.distance = skybox->getSize();
+		skyboxView.xStep = skyboxRotationMatrix * Vec3(inverseProjectionScale, 0.0f, 0.0f);
+		skyboxView.yStep = skyboxRotationMatrix * Vec3(0.0f, -inverseProjectionScale, 0.0f);
 
-			// Build our vertex/unit + world vector lists while we perform
-			// view frustum clipping checks on the polygon
-			for (int i = 0; i < 3; i++) {
-				t_verts[i] = *polygon->vertices[i];
-				t_verts[i].vector = cameraRotationMatrix * (relativeObjectPosition + polygon->vertices[i]->vector);
-				u_vecs[i] = t_verts[i].vector.unit();
-				w_vecs[i] = object->position + polygon->vertices[i]->vector;
-
-				if (t_verts[i].vector.z < NEAR_PLANE_DISTANCE) {
-					frustumCuller.near++;
-				} else if (t_verts[i].vector.z > activeScene->settings.visibility) {
-					frustumCuller.far++;
-				}
+		skyboxView.direction = skyboxRotationMatrix * Vec3(
+			(0.5f - halfRasterArea.width) * inverseProjectionScale,
+			(halfRasterArea.height - 0.5f) * inverseProjectionScale,
+			1.0f
+		);
+	}
 
-				if (u_vecs[i].x < -fovAngleRange) {
-					frustumCuller.left++;
-				} else if (u_vecs[i].x > fovAngleRange) {
-					frustumCuller.right++;
-				}
+	// Gather Objects whose bounds in the Scene's Object tree may be
+	// in view, skipping entire branches of the tree which aren't.
+	// Tree bounds are tested using the spheres enclosing them.
+	activeScene->queryObjects([&](const Bounds& bounds) {
+		Vec3 center = (bounds.cornerA + bounds.cornerB) * 0.5f;
+		float radius = Vec3::distance(bounds.cornerA, bounds.cornerB) * 0.5f;
 
-				if (u_vecs[i].y < -fovAngleRange) {
-					frustumCuller.bottom++;
-				} else if (u_vecs[i].y > fovAngleRange) {
-					frustumCuller.top++;
-				}
-			}
+		return !isSphereCulled(cameraRotationMatrix * (center - camera.position), radius);
+	}, viewableObjects);
 
-			if (frustumCuller.isCulled()) {
-				continue;
-			}
+	// Queue up each Object to be projected, so that the total
+	// range of queued polygons can be divided into sections
+	int totalPolygons = 0;
 
-			if (frustumCuller.near > 0) {
-				// If any vertices are behind the near plane, we have to
-				// clip them against it. This is necessary to prevent
-				// erroneous screen projections at coordinates <= 0.
+	projectedObjects.clear();
 
-				// Sort vertices by descending z-order so we can determine
-				// where to interpolate the clipped vertices
-				if (t_verts[0].vector.z < t_verts[1].vector.z) {
-					swap(t_verts[0], t_verts[1]);
-					swap(u_vecs[0], u_vecs[1]);
-					swap(w_vecs[0], w_vecs[1]);
-				}
+	for (const auto* object : viewableObjects) {
+		Vec3 relativeObjectPosition = object->position - camera.position;
+		const Object* lodObject = object->hasLODs() ? object->getLOD(relativeObjectPosition.magnitude()) : object;
 
-				if (t_verts[1].vector.z < t_verts[2].vector.z) {
-					swap(t_verts[1], t_verts[2]);
-					swap(u_vecs[1], u_vecs[2]);
-					swap(w_vecs[1], w_vecs[2]);
-				}
+		if (!activeScene->isInCurrentOccupiedSector(object->sectorId) || (object == skybox && skyboxView.texture != NULL)) {
+			continue;
+		}
 
-				if (t_verts[0].vector.z < t_verts[1].vector.z) {
-					swap(t_verts[0], t_verts[1]);
-					swap(u_vecs[0], u_vecs[1]);
-					swap(w_vecs[0], w_vecs[1]);
-				}
+		debugStats.countPolygons(lodObject->getPolygonCount());
+		debugStats.countVertices(lodObject->getVertexCount());
 
-				if (frustumCuller.near == 2) {
-					// When two of the polygon's vertices are behind the near
-					// plane, it can be clipped into a smaller polygon at the
-					// plane boundary.
+		if (lodObject->texture != NULL) {
+			lodObject->texture->confirmTexture(renderer, TextureMode::SOFTWARE);
+		}
 
-					// Determine interpolation deltas for each new vertex
-					// (the first need not be interpolated at all)
-					float deltas[3] = {
-						0.0f,
-						(t_verts[0].vector.z - object->nearClippingDistance) / (t_verts[0].vector.z - t_verts[1].vector.z),
-						(t_verts[0].vector.z - object->nearClippingDistance) / (t_verts[0].vector.z - t_verts[2].vector.z)
-					};
+		if (isObjectCulled(lodObject, relativeObjectPosition)) {
+			continue;
+		}
 
-					// Generate new vertices and unit/world vectors for the clipped polygon
-					for (int i = 1; i < 3; i++) {
-						t_verts[i] = Vertex3d::lerp(t_verts[0], t_verts[i], deltas[i]);
-						u_vecs[i] = t_verts[i].vector.unit();
-						w_vecs[i] = Vec3::lerp(w_vecs[0], w_vecs[i], deltas[i]);
-					}
+		projectedObjects.push_back({ object, lodObject, totalPolygons });
 
-					// Project the clipped polygon
-					projectAndQueueTriangle(
-						t_verts, u_vecs, w_vecs,
-						polygon, normalizedDotProduct, projectionScale, true
-					);
-				} else if (frustumCuller.near == 1) {
-					// If only one of the polygon's vertices is behind the
-					// near plane, we need to clip it into a quad, which then
-					// needs to be clipped into two polygons. The first and
-					// second vertices can be preserved, whereas the latter
-					// two will have to be interpolated between the second and
-					// third, and first and third original vertices.
-					Vertex3d quadVerts[4];
-					Vec3 u_quadVecs[4];
-					Vec3 w_quadVecs[4];
+		totalPolygons += lodObject->getPolygonCount();
+	}
 
-					// Determine interpolation deltas for third and fourth vertices
-					float v2Delta = (t_verts[1].vector.z - object->nearClippingDistance) / (t_verts[1].vector.z - t_verts[2].vector.z);
-					float v3Delta = (t_verts[0].vector.z - object->nearClippingDistance) / (t_verts[0].vector.z - t_verts[2].vector.z);
+	// Small scenes are faster to project serially than to hand off
+	// to the render workers, which only poll for work periodically
+	int totalSections = totalPolygons > SERIAL_PROJECTION_POLYGON_LIMIT ? projectionSections.size() : 1;
 
-					// Define new vertices + unit/world vectors for the quad
-					quadVerts[0] = t_verts[0];
-					quadVerts[1] = t_verts[1];
-					quadVerts[2] = Vertex3d::lerp(t_verts[1], t_verts[2], v2Delta);
-					quadVerts[3] = Vertex3d::lerp(t_verts[0], t_verts[2], v3Delta);
+	triangleBuffer->setTotalSubPools(totalSections, totalPolygons);
 
-					u_quadVecs[0] = quadVerts[0].vector.unit();
-					u_quadVecs[1] = quadVerts[1].vector.unit();
-					u_quadVecs[2] = quadVerts[2].vector.unit();
-					u_quadVecs[3] = quadVerts[3].vector.unit();
+	for (int i = 0; i < totalSections; i++) {
+		ProjectionSection& section = projectionSections[i];
 
-					w_quadVecs[0] = w_vecs[0];
-					w_quadVecs[1] = w_vecs[1];
-					w_quadVecs[2] = Vec3::lerp(w_vecs[1], w_vecs[2], v2Delta);
-					w_quadVecs[3] = Vec3::lerp(w_vecs[0], w_vecs[2], v3Delta);
+		section.start = (int)((long long)totalPolygons * i / totalSections);
+		section.end = (int)((long long)totalPolygons * (i + 1) / totalSections);
+	}
 
-					// Project the quad's two polygons individually
-					projectAndQueueTriangle(
-						{ quadVerts[0], quadVerts[1], quadVerts[2] },
-						{ u_quadVecs[0], u_quadVecs[1], u_quadVecs[2] },
-						{ w_quadVecs[0], w_quadVecs[1], w_quadVecs[2] },
-						polygon, normalizedDotProduct, projectionScale, true
-					);
+	if (totalSections > 1) {
+		awaitScreenProjection(totalSections);
 
-					projectAndQueueTriangle(
-						{ quadVerts[0], quadVerts[2], quadVerts[3] },
-						{ u_quadVecs[0], u_quadVecs[2], u_quadVecs[3] },
-						{ w_quadVecs[0], w_quadVecs[2], w_quadVecs[3] },
-						polygon, normalizedDotProduct, projectionScale, true
-					);
-				}
-			} else {
-				// Project a regular, unclipped triangle
-				projectAndQueueTriangle(
-					t_verts, u_vecs, w_vecs,
-					polygon, normalizedDotProduct, projectionScale, false
-				);
-			}
+		// Since each section covers a contiguous range of polygons,
+		// merging them in order yields the same zones as projecting
+		// every polygon serially
+		for (int i = 1; i < totalSections; i++) {
+			rasterFilter->merge(projectionSections[i].rasterFilter);
 		}
+	} else {
+		projectSection(0);
 	}
 }
 
@@ -858,6 +1170,56 @@ void Engine::updateSounds() {
 	}
 }
 
+/**
+ * Transforms a range of an Object's vertices into view space once,
+ * caching their view space vectors, unit vectors and frustum
+ * outcodes by vertex index. Polygons sharing a vertex would
+ * otherwise rotate it and test it against the frustum separately.
+ */
+void Engine::updateViewSpaceCache(ViewSpaceCache& cache, const Object* object, const Vec3& relativeObjectPosition, int firstVertex, int endVertex) {
+	const std::vector<Vertex3d>& vertices = object->getVertices();
+	int totalVertices = vertices.size();
+	float visibility = activeScene->settings.visibility;
+
+	if ((int)cache.vectors.size() < totalVertices) {
+		cache.vectors.resize(totalVertices);
+		cache.unitVectors.resize(totalVertices);
+		cache.outcodes.resize(totalVertices);
+	}
+
+	Vec3* vectors = cache.vectors.data();
+	Vec3* unitVectors = cache.unitVectors.data();
+	int* outcodes = cache.outcodes.data();
+
+	for (int i = firstVertex; i < endVertex; i++) {
+		Vec3 vector = cameraRotationMatrix * (relativeObjectPosition + vertices[i].vector);
+		Vec3 unitVector = vector.unit();
+		int outcode = 0;
+
+		if (vector.z < NEAR_PLANE_DISTANCE) {
+			outcode |= FrustumOutcode::FRUSTUM_NEAR;
+		} else if (vector.z > visibility) {
+			outcode |= FrustumOutcode::FRUSTUM_FAR;
+		}
+
+		if (unitVector.x < -fovAngleRange) {
+			outcode |= FrustumOutcode::FRUSTUM_LEFT;
+		} else if (unitVector.x > fovAngleRange) {
+			outcode |= FrustumOutcode::FRUSTUM_RIGHT;
+		}
+
+		if (unitVector.y < -fovAngleRange) {
+			outcode |= FrustumOutcode::FRUSTUM_BOTTOM;
+		} else if (unitVector.y > fovAngleRange) {
+			outcode |= FrustumOutcode::FRUSTUM_TOP;
+		}
+
+		vectors[i] = vector;
+		unitVectors[i] = unitVector;
+		outcodes[i] = outcode;
+	}
+}
+
 // --------- DEBUGGING --------- //
 
 void Engine::addDebugStats() {
@@ -868,11 +1230,14 @@ void Engine::addDebugStats() {
 	addDebugStat("updateTime");
 	addDebugStat("frameTime");
 	addDebugStat("fps");
+	addDebugStat("allocations");
 	addDebugStat("totalVertices");
 	addDebugStat("totalTriangles");
 	addDebugStat("totalTrianglesProjected");
 	addDebugStat("totalTrianglesDrawn");
 	addDebugStat("totalScanlines");
+	addDebugStat("resolution");
+	addDebugStat("spanKernels");
 }
 
 void Engine::addCommandLineText() {
@@ -893,11 +1258,39 @@ void Engine::updateDebugStats() {
 	updateDebugStat("updateTime", "Update time", debugStats.getUpdateTime());
 	updateDebugStat("frameTime", "Frame time", debugStats.getFrameTime());
 	updateDebugStat("fps", "FPS", debugStats.getFPS());
+#if defined(TRACK_ALLOCATIONS)
+	updateDebugStat("allocations", "Allocations", std::to_string(debugStats.getFrameAllocations()) + " (projection: " + std::to_string(debugStats.getScreenProjectionAllocations()) + ")");
+#endif
 	updateDebugStat("totalVertices", "Vertices", debugStats.getTotalVertices(activeScene->getObjects()));
 	updateDebugStat("totalTriangles", "Triangles", debugStats.getTotalPolygons(activeScene->getObjects()));
 	updateDebugStat("totalTrianglesProjected", "Triangles projected", triangleBuffer->getTotalRequestedTriangles());
 	updateDebugStat("totalTrianglesDrawn", "Triangles drawn", triangleBuffer->getBufferedTriangles().size());
 	updateDebugStat("totalScanlines", "Scanlines", rasterizer->getTotalBufferedScanlines());
+	updateDebugStat("resolution", "Resolution", std::to_string(rasterArea.width) + "x" + std::to_string(rasterArea.height) + " (" + std::to_string(rasterScale) + "%)");
+
+	// List span counts for each span kernel permutation in use,
+	// labeled with the permutation's SpanKernelFeatures flags
+	// (e.g. 'TFL' for textured, fogged, and lit; 'C' for color)
+	std::string spanKernelStats;
+
+	for (int i = 0; i < TOTAL_SPAN_KERNELS; i++) {
+		int totalSpans = rasterizer->getTotalSpans(i);
+
+		if (totalSpans > 0) {
+			std::string label = i == 0 ? "C" : "";
+
+			if (i & SPAN_TEXTURED) label += "T";
+			if (i & SPAN_FOGGED) label += "F";
+			if (i & SPAN_ALPHA_TESTED) label += "A";
+			if (i & SPAN_LIT) label += "L";
+			if (i & SPAN_SUBDIVIDED) label += "S";
+			if (i & SPAN_POWER_OF_TWO) label += "P";
+
+			spanKernelStats += (spanKernelStats.empty() ? "" : ", ") + label + " " + std::to_string(totalSpans);
+		}
+	}
+
+	updateDebugStat("spanKernels", "Spans", spanKernelStats);
 }
 
 void Engine::addDebugStat(const char* key) {
@@ -921,6 +1314,12 @@ void Engine::updateDebugStat(const char* key, const char* label, int value) {
 	text->setValue(statString);
 }
 
+void Engine::updateDebugStat(const char* key, const char* label, const std::string& value) {
+	UIText* text = (UIText*)ui->get(key);
+
+	text->setValue((std::string(label) + ": " + value).c_str());
+}
+
 void Engine::showCommandLine() {
 	commandLine->open();
 	ui->get("commandLineText")->tweenTo({ 10, windowArea.height - 30 }, 500, Ease::quadOut);
@@ -8,14 +8,47 @@
  * -----------
  */
 ColorBuffer::ColorBuffer(int width, int height): width(width), height(height) {
-	buffer = new Color[width * height];
 	bufferSize = width * height;
+
+	allocate();
 }
 
 ColorBuffer::~ColorBuffer() {
 	delete[] buffer;
 }
 
+/**
+ * Determines whether the buffer contains any transparent texels,
+ * building a mask with one bit per texel, including guard texels,
+ * set for each opaque texel if it does. The coverage mask is much
+ * smaller than the buffer itself, allowing passes which only need
+ * to know which pixels an alpha-tested surface covers to avoid
+ * reading full texels.
+ */
+void ColorBuffer::analyzeOpacity() {
+	int totalMaskedTexels = (width + 1) * (height + 1);
+
+	opacity = TextureOpacity::FULLY_OPAQUE;
+
+	coverageMask.assign((totalMaskedTexels + 31) >> 5, 0);
+
+	for (int y = 0; y <= height; y++) {
+		for (int x = 0; x <= width; x++) {
+			if (readUnchecked(x, y) == TEXEL_TRANSPARENT) {
+				opacity = TextureOpacity::ALPHA_TESTED;
+			} else {
+				int index = y * (width + 1) + x;
+
+				coverageMask[index >> 5] |= 1u << (index & 31);
+			}
+		}
+	}
+
+	if (opacity == TextureOpacity::FULLY_OPAQUE) {
+		coverageMask.clear();
+	}
+}
+
 ColorBuffer* ColorBuffer::createDownsizedBuffer() {
 	if (width <= 2 || height <= 2) {
 		return this;
@@ -25,40 +58,133 @@ ColorBuffer* ColorBuffer::createDownsizedBuffer() {
 
 	for (int y = 0; y < height - 1; y +=2) {
 		for (int x = 0; x < width - 1; x += 2) {
-			const Color& tL = read(x, y);
-			const Color& tR = read(x + 1, y);
-			const Color& bL = read(x, y + 1);
-			const Color& bR = read(x + 1, y + 1);
+			Uint32 tL = read(x, y);
+			Uint32 tR = read(x + 1, y);
+			Uint32 bL = read(x, y + 1);
+			Uint32 bR = read(x + 1, y + 1);
 
-			int averageR = (int)((tL.R + tR.R + bL.R + bR.R) / 4.0f);
-			int averageG = (int)((tL.G + tR.G + bL.G + bR.G) / 4.0f);
-			int averageB = (int)((tL.B + tR.B + bL.B + bR.B) / 4.0f);
+			int averageR = (int)((((tL >> 16) & 0xFF) + ((tR >> 16) & 0xFF) + ((bL >> 16) & 0xFF) + ((bR >> 16) & 0xFF)) / 4.0f);
+			int averageG = (int)((((tL >> 8) & 0xFF) + ((tR >> 8) & 0xFF) + ((bL >> 8) & 0xFF) + ((bR >> 8) & 0xFF)) / 4.0f);
+			int averageB = (int)(((tL & 0xFF) + (tR & 0xFF) + (bL & 0xFF) + (bR & 0xFF)) / 4.0f);
 
 			colorBuffer->write(x >> 1, y >> 1, averageR, averageG, averageB);
 		}
 	}
 
+	colorBuffer->setLayout(layout);
+
 	return colorBuffer;
 }
 
-inline int ColorBuffer::getIndex(int x, int y) const {
-	if (x >= width || y >= height) {
-		return 0;
+/**
+ * Allocates the buffer for its current layout, including its
+ * guard texels. Row-major buffers are one texel wider and taller
+ * than the texture, and tiled buffers are one tile wider and
+ * taller than the whole tiles covering the texture, which also
+ * covers any partial tiles along its edges.
+ */
+void ColorBuffer::allocate() {
+	int totalTexels;
+
+	if (layout == TextureLayout::TILED) {
+		stride = (width >> 2) + 1;
+		totalTexels = stride * ((height >> 2) + 1) * 16;
+	} else {
+		stride = width + 1;
+		totalTexels = stride * (height + 1);
 	}
 
-	return width * y + x;
+	buffer = new Uint32[totalTexels];
+
+	std::fill(buffer, buffer + totalTexels, ARGB(0, 0, 0));
+}
+
+const Uint32* ColorBuffer::getBuffer() const {
+	return buffer;
+}
+
+int ColorBuffer::getBufferSize() const {
+	return bufferSize;
+}
+
+TextureLayout ColorBuffer::getLayout() const {
+	return layout;
+}
+
+TextureOpacity ColorBuffer::getOpacity() const {
+	return opacity;
+}
+
+/**
+ * Returns the number of texels per row in row-major layout,
+ * or the number of tiles per row of tiles in tiled layout.
+ */
+int ColorBuffer::getStride() const {
+	return stride;
 }
 
-const Color& ColorBuffer::read(int index) const {
-	return (index < 0 || index >= bufferSize) ? COLOR_BLACK : buffer[index];
+Uint32 ColorBuffer::read(int x, int y) const {
+	if (x < 0 || x >= width || y < 0 || y >= height) {
+		return ARGB(0, 0, 0);
+	}
+
+	return buffer[getTexelIndex(x, y)];
 }
 
-const Color& ColorBuffer::read(int x, int y) const {
-	return read(getIndex(x, y));
+/**
+ * Rearranges the buffer's texels into a different layout.
+ */
+void ColorBuffer::setLayout(TextureLayout layout) {
+	if (layout == this->layout) {
+		return;
+	}
+
+	Uint32* texels = new Uint32[bufferSize];
+
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			texels[y * width + x] = read(x, y);
+		}
+	}
+
+	delete[] buffer;
+
+	this->layout = layout;
+
+	allocate();
+
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			writeTexel(x, y, texels[y * width + x]);
+		}
+	}
+
+	delete[] texels;
 }
 
 void ColorBuffer::write(int x, int y, int R, int G, int B) {
-	Color color = { R, G, B };
+	if (x < 0 || x >= width || y < 0 || y >= height) {
+		return;
+	}
+
+	writeTexel(x, y, ARGB(R, G, B));
+}
+
+/**
+ * Writes a texel, along with any guard texels repeating it.
+ */
+void ColorBuffer::writeTexel(int x, int y, Uint32 color) {
+	buffer[getTexelIndex(x, y)] = color;
+
+	if (x == 0) {
+		buffer[getTexelIndex(width, y)] = color;
+	}
 
-	buffer[getIndex(x, y)] = color;
+	if (y == 0) {
+		buffer[getTexelIndex(x, height)] = color;
+	}
+
+	if (x == 0 && y == 0) {
+		buffer[getTexelIndex(width, height)] = color;
+	}
 }
@@ -109,7 +109,9 @@ Vec3 Illuminator::getTriangleVertexColorIntensity(Triangle* triangle, int vertex
 			computeAmbientLightColorIntensity(normal, triangle->fresnelFactor, colorIntensity);
 		}
 
-		for (auto* light : activeScene->getLights()) {
+		// Only Lights whose range overlaps the source Object can
+		// affect its vertices, so the rest needn't be checked
+		for (auto* light : triangle->sourcePolygon->sourceObject->getNearbyLights()) {
 			bool shouldRecomputeLightColorIntensity = !isStaticTriangle || !light->isStatic;
 
 			if (shouldRecomputeLightColorIntensity) {
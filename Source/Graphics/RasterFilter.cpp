@@ -1,4 +1,5 @@
 #include <Graphics/RasterFilter.h>
+#include <Graphics/TextureBuffer.h>
 #include <algorithm>
 #include <Helpers.h>
 #include <System/Geometry.h>
@@ -56,7 +57,15 @@ bool RasterFilter::isTriangleClockwise(const Triangle* triangle) {
 }
 
 bool RasterFilter::isTriangleCoverable(const Triangle* triangle) {
-	if (!triangle->sourcePolygon->sourceObject->canOccludeSurfaces) {
+	const Object* object = triangle->sourcePolygon->sourceObject;
+
+	if (!object->canOccludeSurfaces) {
+		return false;
+	}
+
+	if (object->texture != NULL && object->texture->opacity != TextureOpacity::FULLY_OPAQUE) {
+		// Triangles with transparent texels may not fully
+		// cover the triangles behind them
 		return false;
 	}
 
@@ -158,6 +167,29 @@ bool RasterFilter::isTriangleVisible(const Triangle* triangle) {
 	return true;
 }
 
+/**
+ * Moves another RasterFilter's Triangles and Covers into this one,
+ * appending each of its zones to the corresponding zone here.
+ * Merging filters in a fixed order thus produces the same zones
+ * as adding all of their Triangles to one filter in that order.
+ */
+void RasterFilter::merge(RasterFilter* filter) {
+	for (int i = 0; i <= filter->highestZoneIndex; i++) {
+		Zone& zone = filter->zones[i];
+
+		zones[i].insert(zones[i].end(), zone.begin(), zone.end());
+		zone.clear();
+	}
+
+	covers.insert(covers.end(), filter->covers.begin(), filter->covers.end());
+
+	if (filter->highestZoneIndex > highestZoneIndex) {
+		highestZoneIndex = filter->highestZoneIndex;
+	}
+
+	filter->reset();
+}
+
 Triangle* RasterFilter::next() {
 	Zone* currentZone = &zones[currentZoneIndex];
 	bool isEndOfZone = currentElementIndex >= currentZone->size() || currentZone->size() == 0;
@@ -189,3 +221,8 @@ void RasterFilter::reset() {
 
 	covers.clear();
 }
+
+void RasterFilter::setResolution(int width, int height) {
+	rasterWidth = width;
+	rasterHeight = height;
+}
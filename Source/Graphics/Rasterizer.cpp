@@ -11,8 +11,105 @@
 #include <System/Objects.h>
 #include <UI/Alert.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 using namespace std;
 
+/**
+ * Creates an edge function for the edge running from c1 to c2,
+ * biased according to the top-left fill rule so that pixels
+ * lying exactly on an edge shared by two triangles are only
+ * ever drawn by one of them.
+ */
+static TriangleEdge createTriangleEdge(const Coordinate& c1, const Coordinate& c2) {
+	TriangleEdge edge;
+
+	edge.a = c1.y - c2.y;
+	edge.b = c2.x - c1.x;
+	edge.c = (long long)(c2.y - c1.y) * c1.x - (long long)(c2.x - c1.x) * c1.y;
+
+	bool isTopLeftEdge = edge.a > 0 || (edge.a == 0 && edge.b < 0);
+
+	if (!isTopLeftEdge) {
+		edge.c -= 1;
+	}
+
+	return edge;
+}
+
+/**
+ * Computes the screen-space x and y gradients of an attribute
+ * with values a0, a1, and a2 at the respective vertices of a
+ * triangle, where d1 and d2 are the offsets of the second and
+ * third vertices from the first.
+ */
+static void computeGradient(float a0, float a1, float a2, const Coordinate& d1, const Coordinate& d2, float inverseArea, float& dx, float& dy) {
+	float da1 = a1 - a0;
+	float da2 = a2 - a0;
+
+	dx = (da1 * d2.y - da2 * d1.y) * inverseArea;
+	dy = (da2 * d1.x - da1 * d2.x) * inverseArea;
+}
+
+/**
+ * Samples a skybox texture in a given view direction. Skybox textures
+ * are laid out as a horizontal cross of cube faces, each of which is
+ * a quarter of the texture wide and a third of it tall, in line with
+ * the UV coordinates of Skybox objects.
+ */
+static inline Uint32 sampleSkybox(const ColorBuffer* mipmap, const Vec3& direction) {
+	float x = fabsf(direction.x);
+	float y = fabsf(direction.y);
+	float z = fabsf(direction.z);
+	float u;
+	float v;
+
+	if (x >= y && x >= z) {
+		float ratio = 1.0f / x;
+
+		u = direction.x < 0.0f ? 0.875f + 0.125f * direction.z * ratio : 0.375f - 0.125f * direction.z * ratio;
+		v = 0.5f - (direction.y * ratio) / 6.0f;
+	} else if (z >= y) {
+		float ratio = 1.0f / z;
+
+		u = direction.z < 0.0f ? 0.625f - 0.125f * direction.x * ratio : 0.125f + 0.125f * direction.x * ratio;
+		v = 0.5f - (direction.y * ratio) / 6.0f;
+	} else {
+		float ratio = 1.0f / y;
+
+		u = 0.375f - 0.125f * direction.z * ratio;
+		v = direction.y < 0.0f ? (5.0f - direction.x * ratio) / 6.0f : (1.0f + direction.x * ratio) / 6.0f;
+	}
+
+	return mipmap->readUnchecked((int)(u * mipmap->width), (int)(v * mipmap->height));
+}
+
+/**
+ * Evaluates the attributes of a set-up triangle at a given pixel.
+ */
+static Interpolants interpolateTriangleSetup(const TriangleSetup& setup, int x, int y) {
+	const Interpolants& start = setup.start;
+	const Interpolants& dx = setup.dx;
+	const Interpolants& dy = setup.dy;
+	float offsetX = (float)(x - setup.origin.x);
+	float offsetY = (float)(y - setup.origin.y);
+	Interpolants values;
+
+	values.inverseDepth = start.inverseDepth + dx.inverseDepth * offsetX + dy.inverseDepth * offsetY;
+	values.perspectiveUV.x = start.perspectiveUV.x + dx.perspectiveUV.x * offsetX + dy.perspectiveUV.x * offsetY;
+	values.perspectiveUV.y = start.perspectiveUV.y + dx.perspectiveUV.y * offsetX + dy.perspectiveUV.y * offsetY;
+	values.textureIntensity.x = start.textureIntensity.x + dx.textureIntensity.x * offsetX + dy.textureIntensity.x * offsetY;
+	values.textureIntensity.y = start.textureIntensity.y + dx.textureIntensity.y * offsetX + dy.textureIntensity.y * offsetY;
+	values.textureIntensity.z = start.textureIntensity.z + dx.textureIntensity.z * offsetX + dy.textureIntensity.z * offsetY;
+	values.color.x = start.color.x + dx.color.x * offsetX + dy.color.x * offsetY;
+	values.color.y = start.color.y + dx.color.y * offsetX + dy.color.y * offsetY;
+	values.color.z = start.color.z + dx.color.z * offsetX + dy.color.z * offsetY;
+
+	return values;
+}
+
 /**
  * Rasterizer
  * ----------
@@ -20,177 +117,344 @@ using namespace std;
 Rasterizer::Rasterizer(SDL_Renderer* renderer, int width, int height) {
 	this->width = width;
 	this->height = height;
+	bufferWidth = width;
+	bufferHeight = height;
+
+	createFramebuffers(renderer);
 
-	screenTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, width, height);
-	pixelBuffer = new Uint32[width * height];
-	depthBuffer = new float[width * height];
-	scanlines = new Scanline[width * height];
-	bufferSize = width * height;
+	depthBuffer = new float[pitch * height];
+	rowDepthEpochs = new Uint32[height];
+	visibilityBuffer = new Uint32[pitch * height];
+
+	totalTileColumns = (width + TILE_SIZE - 1) / TILE_SIZE;
+	totalTileRows = (height + TILE_SIZE - 1) / TILE_SIZE;
+	tileDepthBuffer = new float[totalTileColumns * totalTileRows];
+	tileRowDepthBuffer = new float[totalTileColumns * height];
+
+	totalBands = (height + RASTER_BAND_HEIGHT - 1) / RASTER_BAND_HEIGHT;
+	totalAllocatedBands = totalBands;
+	bands = new RasterBand[totalBands];
+
+	fill(depthBuffer, depthBuffer + pitch * height, 0.0f);
+	fill(rowDepthEpochs, rowDepthEpochs + height, depthEpoch);
+	fill(visibilityBuffer, visibilityBuffer + pitch * height, 0);
 
 	clear();
 }
 
 Rasterizer::~Rasterizer() {
-	SDL_DestroyTexture(screenTexture);
+	for (auto& framebuffer : framebuffers) {
+		if (framebuffer.isLocked) {
+			SDL_UnlockTexture(framebuffer.texture);
+		}
+
+		if (!framebuffer.isStreaming) {
+			delete[] framebuffer.pixels;
+		}
+
+		SDL_DestroyTexture(framebuffer.texture);
+	}
 
-	delete[] pixelBuffer;
 	delete[] depthBuffer;
-	delete[] scanlines;
+	delete[] rowDepthEpochs;
+	delete[] visibilityBuffer;
+	delete[] tileDepthBuffer;
+	delete[] tileRowDepthBuffer;
+	delete[] bands;
+
+	for (auto* block : scanlineBlocks) {
+		delete[] block;
+	}
 }
 
+/**
+ * Resets the rasterizer for a new frame. The pixel and depth buffers
+ * aren't cleared here, but one band at a time just before each band
+ * is rasterized, spreading the clear across the render workers.
+ *
+ * Each frame starts a new depth epoch. Every screen row is stamped
+ * with the epoch its depth values were last cleared in, and with depth
+ * epochs enabled, rows are only cleared once they're first drawn to in
+ * a frame rather than up front, so rows left uncovered by geometry are
+ * never cleared at all. Depth values themselves are never offset, and
+ * keep their full precision.
+ */
 void Rasterizer::clear() {
-	int bufferLength = width * height;
-	Uint32 clearColor = ARGB(backgroundColor.R, backgroundColor.G, backgroundColor.B);
+	depthEpoch++;
+
+	currentFramebuffer = (currentFramebuffer + 1) % TOTAL_FRAMEBUFFERS;
+
+	lockFramebuffer(framebuffers[currentFramebuffer]);
+
+	for (int i = 0; i < totalAllocatedBands; i++) {
+		bands[i].blocks.clear();
+		bands[i].totalScanlines = 0;
+		bands[i].triangleSetups.clear();
+
+		fill(bands[i].totalSpans, bands[i].totalSpans + TOTAL_SPAN_KERNELS, 0);
+	}
+
+	totalClaimedScanlineBlocks = 0;
+
+	triangleSetups.clear();
+}
+
+/**
+ * Clears the screen rows and tile depths covered by a band. The
+ * color clear is skipped when the background is known to be covered
+ * by opaque geometry or a skybox, and the depth clear is deferred
+ * to each row's first span when depth epochs are enabled.
+ */
+void Rasterizer::clearBand(int bandIndex) {
+	int top = bandIndex * RASTER_BAND_HEIGHT;
+	int bottom = FAST_MIN(top + RASTER_BAND_HEIGHT, height);
+
+	for (int y = top; y < bottom; y++) {
+		int start = y * pitch;
+		int end = start + width;
+
+		if (!isBackgroundCovered && skyboxView.texture == NULL) {
+			fill(pixelBuffer + start, pixelBuffer + end, ARGB(backgroundColor.R, backgroundColor.G, backgroundColor.B));
+		}
+
+		if (!useDepthEpochs) {
+			clearRowDepth(y);
+		}
+	}
+
+	// Bands are a whole number of tiles tall, so tile rows never
+	// straddle two bands
+	int tileTop = top / TILE_SIZE;
+	int tileBottom = (bottom + TILE_SIZE - 1) / TILE_SIZE;
+
+	fill(tileDepthBuffer + tileTop * totalTileColumns, tileDepthBuffer + tileBottom * totalTileColumns, 0.0f);
+	fill(tileRowDepthBuffer + top * totalTileColumns, tileRowDepthBuffer + bottom * totalTileColumns, 0.0f);
+}
+
+void Rasterizer::clearRowDepth(int y) {
+	int start = y * pitch;
+
+	fill(depthBuffer + start, depthBuffer + start + width, 0.0f);
+
+	rowDepthEpochs[y] = depthEpoch;
+}
+
+/**
+ * Creates the ring of framebuffers which frames are rasterized into
+ * and presented from, so that a finished frame can be presented while
+ * the next one is rasterized into another framebuffer. Where the
+ * renderer supports streaming textures, frames are rasterized directly
+ * into each framebuffer texture's locked pixels, so presenting them
+ * doesn't require copying the whole frame into the texture. Otherwise,
+ * frames are rasterized into separate pixel buffers which are uploaded
+ * to static textures on present. The depth and visibility buffers share
+ * the framebuffers' row pitch, so that all three can be addressed with
+ * the same index.
+ */
+void Rasterizer::createFramebuffers(SDL_Renderer* renderer) {
+	hasStreamingTextures = true;
+
+	for (auto& framebuffer : framebuffers) {
+		framebuffer.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+
+		void* pixels;
+		int texturePitch;
+
+		if (
+			framebuffer.texture == NULL ||
+			SDL_LockTexture(framebuffer.texture, NULL, &pixels, &texturePitch) != 0
+		) {
+			hasStreamingTextures = false;
+			break;
+		}
+
+		bool hasValidPitch = (
+			texturePitch % sizeof(Uint32) == 0 &&
+			(&framebuffer == framebuffers || texturePitch == pitch * (int)sizeof(Uint32))
+		);
+
+		if (hasValidPitch) {
+			pitch = texturePitch / sizeof(Uint32);
+
+			fill((Uint32*)pixels, (Uint32*)pixels + pitch * height, ARGB(0, 0, 0));
+		}
+
+		SDL_UnlockTexture(framebuffer.texture);
+
+		if (!hasValidPitch) {
+			hasStreamingTextures = false;
+			break;
+		}
 
-	fill(pixelBuffer, pixelBuffer + bufferLength, clearColor);
-	fill(depthBuffer, depthBuffer + bufferLength, 0.0f);
+		framebuffer.isStreaming = true;
+	}
+
+	if (!hasStreamingTextures) {
+		pitch = width;
+
+		for (auto& framebuffer : framebuffers) {
+			if (framebuffer.texture != NULL) {
+				SDL_DestroyTexture(framebuffer.texture);
+			}
 
-	totalBufferedScanlines = 0;
+			framebuffer.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, width, height);
+			framebuffer.pixels = new Uint32[width * height];
+			framebuffer.isStreaming = false;
+
+			fill(framebuffer.pixels, framebuffer.pixels + width * height, ARGB(0, 0, 0));
+		}
+	}
 }
 
 void Rasterizer::dispatchTriangle(Triangle& triangle) {
+	if (rasterMode == RasterMode::TILE) {
+		dispatchTileTriangle(triangle);
+
+		return;
+	}
+
+	int setupIndex = setupTriangle(triangle);
+
+	if (setupIndex == -1) {
+		// Optimize for offscreen or degenerate triangles
+		return;
+	}
+
 	// Sort each vertex from top to bottom
-	Vertex2d* top = &triangle.vertices[0];
-	Vertex2d* middle = &triangle.vertices[1];
-	Vertex2d* bottom = &triangle.vertices[2];
-	const TextureBuffer* texture = triangle.sourcePolygon->sourceObject->texture;
+	const Coordinate* top = &triangle.vertices[0].coordinate;
+	const Coordinate* middle = &triangle.vertices[1].coordinate;
+	const Coordinate* bottom = &triangle.vertices[2].coordinate;
 
-	if (top->coordinate.y > middle->coordinate.y) {
+	if (top->y > middle->y) {
 		swap(top, middle);
 	}
 
-	if (middle->coordinate.y > bottom->coordinate.y) {
+	if (middle->y > bottom->y) {
 		swap(middle, bottom);
 	}
 
-	if (top->coordinate.y > middle->coordinate.y) {
+	if (top->y > middle->y) {
 		swap(top, middle);
 	}
 
-	if (top->coordinate.y >= height || bottom->coordinate.y < 0) {
-		// Optimize for vertically offscreen triangles
-		return;
-	}
-
-	if (top->coordinate.y == middle->coordinate.y) {
+	if (top->y == middle->y) {
 		// Trivial case #1: Triangle with a flat top edge
-		if (top->coordinate.x > middle->coordinate.x) {
+		if (top->x > middle->x) {
 			swap(top, middle);
 		}
 
-		dispatchFlatTopTriangle(*top, *middle, *bottom, texture);
-	} else if (bottom->coordinate.y == middle->coordinate.y) {
+		dispatchFlatTopTriangle(*top, *middle, *bottom, setupIndex);
+	} else if (bottom->y == middle->y) {
 		// Trivial case #2: Triangle with a flat bottom edge
-		if (bottom->coordinate.x < middle->coordinate.x) {
+		if (bottom->x < middle->x) {
 			swap(bottom, middle);
 		}
 
-		dispatchFlatBottomTriangle(*top, *middle, *bottom, texture);
+		dispatchFlatBottomTriangle(*top, *middle, *bottom, setupIndex);
 	} else {
 		// Nontrivial case: Triangle with neither a flat top nor
 		// flat bottom edge. These must be rasterized as two
 		// separate flat-bottom-edge and flat-top-edge triangles.
-		float middleYProgress = (float)(middle->coordinate.y - top->coordinate.y) / (bottom->coordinate.y - top->coordinate.y);
+		float middleYProgress = (float)(middle->y - top->y) / (bottom->y - top->y);
 
 		// To rasterize each half of the triangle properly, we must
 		// construct an intermediate vertex along its hypotenuse,
-		// level with the actual middle vertex.
-		Vertex2d hypotenuseVertex = Vertex2d::lerp(*top, *bottom, middleYProgress);
-
-		// Lock the y coordinate of the new vertex to that of the
-		// middle vertex to avoid potential lerp rounding errors
-		hypotenuseVertex.coordinate.y = middle->coordinate.y;
+		// level with the actual middle vertex. Attributes are read
+		// from the triangle's gradients, so only its position is
+		// needed.
+		Coordinate hypotenuseVertex = { Lerp::lerp(top->x, bottom->x, middleYProgress), middle->y };
 
-		Vertex2d* middleLeft = middle;
-		Vertex2d* middleRight = &hypotenuseVertex;
+		const Coordinate* middleLeft = middle;
+		const Coordinate* middleRight = &hypotenuseVertex;
 
-		if (middleLeft->coordinate.x > middleRight->coordinate.x) {
+		if (middleLeft->x > middleRight->x) {
 			swap(middleLeft, middleRight);
 		}
 
-		dispatchFlatBottomTriangle(*top, *middleLeft, *middleRight, texture);
-		dispatchFlatTopTriangle(*middleLeft, *middleRight, *bottom, texture);
+		dispatchFlatBottomTriangle(*top, *middleLeft, *middleRight, setupIndex);
+		dispatchFlatTopTriangle(*middleLeft, *middleRight, *bottom, setupIndex);
 	}
 }
 
-void Rasterizer::dispatchFlatTriangle(const Vertex2d& corner, const Vertex2d& left, const Vertex2d& right, const TextureBuffer* texture) {
+/**
+ * Dispatches one Scanline per screen row covered by a triangle
+ * half with a flat top or bottom edge. Scanlines only store their
+ * attribute values at their starting pixel; per-pixel steps are
+ * read from the triangle's gradients when they are rasterized.
+ */
+void Rasterizer::dispatchFlatTriangle(const Coordinate& corner, const Coordinate& left, const Coordinate& right, int setupIndex) {
 	int isHorizontallyOffscreen = (
-		(corner.coordinate.x >= width && left.coordinate.x >= width) ||
-		(corner.coordinate.x < 0 && right.coordinate.x < 0)
+		(corner.x >= width && left.x >= width) ||
+		(corner.x < 0 && right.x < 0)
 	);
 
 	if (isHorizontallyOffscreen) {
 		return;
 	}
 
-	int triangleHeight = abs(left.coordinate.y - corner.coordinate.y);
-	int topY = FAST_MIN(corner.coordinate.y, left.coordinate.y);
+	const TriangleSetup& setup = triangleSetups[setupIndex];
+	bool isTextured = setup.texture != NULL;
+	int triangleHeight = abs(left.y - corner.y);
+	int topY = FAST_MIN(corner.y, left.y);
 	int start = FAST_MAX(topY, 0);
 	int end = FAST_MIN(topY + triangleHeight, height);
-	bool hasFlatTop = corner.coordinate.y > left.coordinate.y;
+	bool hasFlatTop = corner.y > left.y;
 
 	for (int y = start; y < end; y++) {
 		int step = hasFlatTop ? (triangleHeight - (y - topY)) : (y - topY);
 		float progress = (float)step / triangleHeight;
-		int startX = Lerp::lerp(corner.coordinate.x, left.coordinate.x, progress);
-		int endX = Lerp::lerp(corner.coordinate.x, right.coordinate.x, progress);
+		int startX = Lerp::lerp(corner.x, left.x, progress);
+		int endX = Lerp::lerp(corner.x, right.x, progress);
 		int length = endX - startX;
 
 		if (length == 0) {
 			continue;
 		}
 
-		if (totalBufferedScanlines >= bufferSize) {
-			Alert::error(ALERT_ERROR, "Scanline buffer overflow");
-			exit(0);
-		}
-
-		Scanline* scanline = &scanlines[totalBufferedScanlines++];
+		Scanline* scanline = requestScanline(y);
+		Interpolants values = interpolateTriangleSetup(setup, startX, y);
 
 		scanline->x = startX;
 		scanline->y = y;
 		scanline->length = length;
-		scanline->texture = texture;
+		scanline->triangleSetup = setupIndex;
+		scanline->inverseDepth = values.inverseDepth;
 
-		scanline->inverseDepth.start = Lerp::lerp(corner.inverseDepth, left.inverseDepth, progress);
-		scanline->inverseDepth.end = Lerp::lerp(corner.inverseDepth, right.inverseDepth, progress);
-
-		if (texture != NULL) {
-			scanline->perspectiveUV.start.x = Lerp::lerp(corner.perspectiveUV.x, left.perspectiveUV.x, progress);
-			scanline->perspectiveUV.start.y = Lerp::lerp(corner.perspectiveUV.y, left.perspectiveUV.y, progress);
-
-			scanline->perspectiveUV.end.x = Lerp::lerp(corner.perspectiveUV.x, right.perspectiveUV.x, progress);
-			scanline->perspectiveUV.end.y = Lerp::lerp(corner.perspectiveUV.y, right.perspectiveUV.y, progress);
-
-			scanline->textureIntensity.start.x = Lerp::lerp(corner.textureIntensity.x, left.textureIntensity.x, progress);
-			scanline->textureIntensity.start.y = Lerp::lerp(corner.textureIntensity.y, left.textureIntensity.y, progress);
-			scanline->textureIntensity.start.z = Lerp::lerp(corner.textureIntensity.z, left.textureIntensity.z, progress);
-
-			scanline->textureIntensity.end.x = Lerp::lerp(corner.textureIntensity.x, right.textureIntensity.x, progress);
-			scanline->textureIntensity.end.y = Lerp::lerp(corner.textureIntensity.y, right.textureIntensity.y, progress);
-			scanline->textureIntensity.end.z = Lerp::lerp(corner.textureIntensity.z, right.textureIntensity.z, progress);
+		if (isTextured) {
+			scanline->texturing.perspectiveUV = values.perspectiveUV;
+			scanline->texturing.textureIntensity = values.textureIntensity;
 		} else {
-			scanline->color.start.R = Lerp::lerp(corner.color.R, left.color.R, progress);
-			scanline->color.start.G = Lerp::lerp(corner.color.G, left.color.G, progress);
-			scanline->color.start.B = Lerp::lerp(corner.color.B, left.color.B, progress);
-
-			scanline->color.end.R = Lerp::lerp(corner.color.R, right.color.R, progress);
-			scanline->color.end.G = Lerp::lerp(corner.color.G, right.color.G, progress);
-			scanline->color.end.B = Lerp::lerp(corner.color.B, right.color.B, progress);
+			scanline->color = values.color;
 		}
 	}
 }
 
-void Rasterizer::dispatchFlatBottomTriangle(const Vertex2d& top, const Vertex2d& bottomLeft, const Vertex2d& bottomRight, const TextureBuffer* texture) {
-	dispatchFlatTriangle(top, bottomLeft, bottomRight, texture);
+void Rasterizer::dispatchFlatBottomTriangle(const Coordinate& top, const Coordinate& bottomLeft, const Coordinate& bottomRight, int setupIndex) {
+	dispatchFlatTriangle(top, bottomLeft, bottomRight, setupIndex);
 }
 
-void Rasterizer::dispatchFlatTopTriangle(const Vertex2d& topLeft, const Vertex2d& topRight, const Vertex2d& bottom, const TextureBuffer* texture) {
-	dispatchFlatTriangle(bottom, topLeft, topRight, texture);
+void Rasterizer::dispatchFlatTopTriangle(const Coordinate& topLeft, const Coordinate& topRight, const Coordinate& bottom, int setupIndex) {
+	dispatchFlatTriangle(bottom, topLeft, topRight, setupIndex);
 }
 
-const Scanline* Rasterizer::getScanline(int index) {
-	return &scanlines[index];
+/**
+ * Sets up a triangle and bins it into each band of screen rows it
+ * overlaps. Unlike scanline rasterization, no intermediate per-row
+ * records are produced; tiles are shaded directly from the triangle
+ * setup once bands are rasterized.
+ */
+void Rasterizer::dispatchTileTriangle(const Triangle& triangle) {
+	int setupIndex = setupTriangle(triangle);
+
+	if (setupIndex == -1) {
+		return;
+	}
+
+	const TriangleSetup& setup = triangleSetups[setupIndex];
+
+	for (int i = setup.topLeft.y / RASTER_BAND_HEIGHT; i <= setup.bottomRight.y / RASTER_BAND_HEIGHT; i++) {
+		bands[i].triangleSetups.push_back(setupIndex);
+	}
 }
 
 int Rasterizer::getColorLerpInterval(const Color& start, const Color& end, int lineLength) {
@@ -202,16 +466,58 @@ int Rasterizer::getColorLerpInterval(const Color& start, const Color& end, int l
 	return colorDelta > 0 ? FAST_MAX(MIN_COLOR_LERP_INTERVAL, (int)(lineLength / colorDelta)) : lineLength;
 }
 
-int Rasterizer::getMipmapLevel(float averageDepth) {
-	float depthMultiple = averageDepth / MIPMAP_DISTANCE_INTERVAL;
+/**
+ * Determines the mipmap level at which a texture maps roughly one
+ * texel to each pixel, given the number of full-size texels covering
+ * each pixel. Each mipmap level halves the texture's width and
+ * height, quartering the texels covering each pixel. Triangles
+ * with degenerate texture coordinates cover no texels at all, so
+ * the texel count is clamped before taking its logarithm, which
+ * would otherwise be infinite.
+ */
+int Rasterizer::getMipmapLevel(float texelsPerPixel) {
+	float level = 0.5f * log2f(FAST_MAX(texelsPerPixel, 1.0f));
+
+	return (int)FAST_CLAMP(level, 0.0f, (float)MAX_MIPMAP_LEVEL);
+}
+
+/**
+ * Selects the span kernel permutation for a triangle based on
+ * its source Object, its selected mipmap, and the current scene
+ * settings. Only triangles whose mipmap has transparent texels
+ * need to alpha test their samples.
+ */
+int Rasterizer::getSpanKernel(const Triangle& triangle, const ColorBuffer* mipmap) {
+	const Object* object = triangle.sourcePolygon->sourceObject;
+	const TextureBuffer* texture = object->texture;
+
+	if (texture == NULL) {
+		return 0;
+	}
+
+	int spanKernel = SPAN_TEXTURED;
+
+	if (visibility < INT_MAX) {
+		spanKernel |= SPAN_FOGGED;
+	}
+
+	if (mipmap->getOpacity() == TextureOpacity::ALPHA_TESTED) {
+		spanKernel |= SPAN_ALPHA_TESTED;
+	}
+
+	if (object->hasLighting) {
+		spanKernel |= SPAN_LIT;
+	}
+
+	if (perspectiveSpanLength > 0) {
+		spanKernel |= SPAN_SUBDIVIDED;
 
-	for (int i = 0; i < 12; i++) {
-		if (depthMultiple < LOG2_TABLE[i][0]) {
-			return LOG2_TABLE[i - 1][1];
+		if (texture->isPowerOfTwo) {
+			spanKernel |= SPAN_POWER_OF_TWO;
 		}
 	}
 
-	return 10;
+	return spanKernel;
 }
 
 int Rasterizer::getTextureSampleInterval(int lineLength, float averageDepth) {
@@ -220,8 +526,133 @@ int Rasterizer::getTextureSampleInterval(int lineLength, float averageDepth) {
 	return FAST_CLAMP(interval, 1, MAX_TEXTURE_SAMPLE_INTERVAL);
 }
 
+/**
+ * Inserts a span into the span buffer row for screen row y, keeping
+ * only its sections which are nearer than the segments already in
+ * the row, and trimming or splitting any segments it occludes. Since
+ * inverse depth is linear in screen x, the nearer of two overlapping
+ * segments can change at most once, at the point where their inverse
+ * depths cross.
+ */
+void Rasterizer::insertSpanSegment(const SpanSegment& segment, int y) {
+	RasterBand& band = bands[y / RASTER_BAND_HEIGHT];
+	std::vector<SpanSegment>& segments = band.spanSegments[y % RASTER_BAND_HEIGHT];
+	std::vector<SpanSegment>& merged = band.mergedSpanSegments;
+	int cursor = segment.start;
+
+	// Appends a clipped section of a segment to the merged
+	// sections replacing the overlapped segments, joining it with
+	// the previous section where both belong to the same span
+	auto append = [&](const SpanSegment& source, int start, int end) {
+		if (start > end) {
+			return;
+		}
+
+		if (merged.size() > 0) {
+			SpanSegment& last = merged.back();
+
+			if (last.triangleSetup == source.triangleSetup && last.end + 1 == start && last.inverseDepthStep == source.inverseDepthStep) {
+				last.end = end;
+
+				return;
+			}
+		}
+
+		merged.push_back({
+			start,
+			end,
+			source.inverseDepth + source.inverseDepthStep * (start - source.start),
+			source.inverseDepthStep,
+			source.triangleSetup
+		});
+	};
+
+	auto inverseDepthAt = [](const SpanSegment& source, int x) {
+		return source.inverseDepth + source.inverseDepthStep * (x - source.start);
+	};
+
+	// Find the range of existing segments overlapping the new one,
+	// which are the only ones that may need to be trimmed or split
+	auto first = lower_bound(segments.begin(), segments.end(), segment.start, [](const SpanSegment& existing, int x) {
+		return existing.end < x;
+	});
+
+	auto last = first;
+
+	while (last != segments.end() && last->start <= segment.end) {
+		last++;
+	}
+
+	if (first == last) {
+		segments.insert(first, segment);
+
+		return;
+	}
+
+	merged.clear();
+
+	for (auto existing = first; existing != last; existing++) {
+		int overlapStart = FAST_MAX(existing->start, cursor);
+		int overlapEnd = FAST_MIN(existing->end, segment.end);
+
+		append(segment, cursor, overlapStart - 1);
+		append(*existing, existing->start, overlapStart - 1);
+
+		float startDelta = inverseDepthAt(segment, overlapStart) - inverseDepthAt(*existing, overlapStart);
+		float endDelta = inverseDepthAt(segment, overlapEnd) - inverseDepthAt(*existing, overlapEnd);
+
+		if (startDelta > 0.0f && endDelta > 0.0f) {
+			append(segment, overlapStart, overlapEnd);
+		} else if (startDelta <= 0.0f && endDelta <= 0.0f) {
+			append(*existing, overlapStart, overlapEnd);
+		} else {
+			// The two segments cross within the overlap; split
+			// it at the last pixel where the nearer segment at
+			// the start of the overlap still wins
+			int crossing = overlapStart + (int)((overlapEnd - overlapStart) * startDelta / (startDelta - endDelta));
+			int split = FAST_CLAMP(crossing, overlapStart, overlapEnd - 1);
+			const SpanSegment& nearer = startDelta > 0.0f ? segment : *existing;
+			const SpanSegment& farther = startDelta > 0.0f ? *existing : segment;
+
+			append(nearer, overlapStart, split);
+			append(farther, split + 1, overlapEnd);
+		}
+
+		append(*existing, overlapEnd + 1, existing->end);
+
+		cursor = overlapEnd + 1;
+	}
+
+	append(segment, cursor, segment.end);
+
+	int index = first - segments.begin();
+
+	segments.erase(first, last);
+	segments.insert(segments.begin() + index, merged.begin(), merged.end());
+}
+
+int Rasterizer::getTotalBands() {
+	return totalBands;
+}
+
 int Rasterizer::getTotalBufferedScanlines() {
-	return totalBufferedScanlines;
+	int total = 0;
+
+	for (int i = 0; i < totalBands; i++) {
+		total += bands[i].totalScanlines;
+	}
+
+	return total;
+}
+
+int Rasterizer::getTotalSpans(int spanKernel) {
+	int total = 0;
+
+	for (int i = 0; i < totalBands; i++) {
+		total += bands[i].totalSpans[spanKernel];
+	}
+
+	return total;
 }
 
 void Rasterizer::line(int x1, int y1, int x2, int y2) {
@@ -264,159 +695,1052 @@ void Rasterizer::line(int x1, int y1, int x2, int y2) {
 	}
 }
 
-void Rasterizer::render(SDL_Renderer* renderer, int sizeFactor = 1) {
-	SDL_Rect destinationRect = { offset.x, offset.y, sizeFactor * width, sizeFactor * height };
+/**
+ * Prepares a framebuffer for the next frame to be rasterized into,
+ * locking its streaming texture until the frame is presented. If the
+ * texture can't be locked with the pitch probed at creation, frames
+ * fall back to a separate pixel buffer which is uploaded on present.
+ */
+void Rasterizer::lockFramebuffer(Framebuffer& framebuffer) {
+	framebuffer.width = width;
+	framebuffer.height = height;
+	framebuffer.pitch = pitch;
+
+	if (framebuffer.isStreaming && !framebuffer.isLocked) {
+		void* pixels;
+		int texturePitch;
+
+		if (SDL_LockTexture(framebuffer.texture, NULL, &pixels, &texturePitch) == 0) {
+			if (texturePitch == pitch * (int)sizeof(Uint32)) {
+				framebuffer.pixels = (Uint32*)pixels;
+				framebuffer.isLocked = true;
+			} else {
+				SDL_UnlockTexture(framebuffer.texture);
+			}
+		}
 
-	SDL_UpdateTexture(screenTexture, NULL, pixelBuffer, width * sizeof(Uint32));
-	SDL_RenderCopy(renderer, screenTexture, NULL, &destinationRect);
-}
+		if (!framebuffer.isLocked) {
+			framebuffer.isStreaming = false;
+			framebuffer.pixels = new Uint32[pitch * bufferHeight];
 
-void Rasterizer::setBackgroundColor(const Color& color) {
-	backgroundColor.R = color.R;
-	backgroundColor.G = color.G;
-	backgroundColor.B = color.B;
-}
+			fill(framebuffer.pixels, framebuffer.pixels + pitch * bufferHeight, ARGB(0, 0, 0));
+		}
+	}
 
-void Rasterizer::setDrawColor(Uint32 color) {
-	drawColor = color;
+	pixelBuffer = framebuffer.pixels;
 }
 
-void Rasterizer::setDrawColor(int R, int G, int B) {
-	drawColor = ARGB(R, G, B);
-}
+/**
+ * Clears and rasterizes all triangles binned into a given band.
+ * Since bands cover disjoint sets of screen rows, separate bands
+ * can safely be rasterized in parallel. In deferred shading mode,
+ * the band's visible pixels are then shaded from the visibility
+ * buffer. Any pixels left uncovered by the band's triangles are
+ * finally filled in from the skybox.
+ */
+void Rasterizer::rasterizeBand(int bandIndex) {
+	clearBand(bandIndex);
+
+	if (shadingMode == ShadingMode::SPAN_BUFFER) {
+		// Alpha-tested triangles don't fully cover their spans,
+		// so they can't be clipped against or resolved as span
+		// segments; instead, they're depth tested against the
+		// band's resolved segments afterward.
+		rasterizeBandTriangles(bandIndex, true, false);
+		resolveSpanBufferBand(bandIndex);
+		rasterizeBandTriangles(bandIndex, false, true);
+	} else {
+		rasterizeBandTriangles(bandIndex, true, true);
 
-void Rasterizer::setDrawColor(const Color& color) {
-	setDrawColor(color.R, color.G, color.B);
-}
+		if (shadingMode == ShadingMode::DEFERRED) {
+			resolveVisibilityBand(bandIndex);
+		}
+	}
 
-void Rasterizer::setOffset(const Coordinate& offset) {
-	this->offset.x = offset.x;
-	this->offset.y = offset.y;
+	if (skyboxView.texture != NULL) {
+		shadeSkyboxBand(bandIndex);
+	}
 }
 
-void Rasterizer::setPixel(int x, int y) {
-	int index = y * width + x;
+void Rasterizer::rasterizeBandTriangles(int bandIndex, bool includeOpaque, bool includeAlphaTested) {
+	const RasterBand& band = bands[bandIndex];
 
-	pixelBuffer[index] = drawColor;
-}
+	if (rasterMode == RasterMode::TILE) {
+		rasterizeTileBand(band, bandIndex, includeOpaque, includeAlphaTested);
 
-void Rasterizer::setVisibility(int visibility) {
-	this->visibility = visibility;
-}
+		return;
+	}
 
-void Rasterizer::triangle(int x1, int y1, int x2, int y2, int x3, int y3) {
-	line(x1, y1, x2, y2);
-	line(x2, y2, x3, y3);
-	line(x3, y3, x1, y1);
-}
+	for (int i = 0; i < band.totalScanlines; i++) {
+		const Scanline* scanline = &band.blocks[i / SCANLINE_BLOCK_SIZE][i % SCANLINE_BLOCK_SIZE];
+		bool isAlphaTested = (triangleSetups[scanline->triangleSetup].spanKernel & SPAN_ALPHA_TESTED) != 0;
 
-void Rasterizer::triangleScanline(const Scanline* scanline) {
-	triangleScanline(
-		scanline->x, scanline->y, scanline->length,
-		scanline->color,
-		scanline->inverseDepth,
-		scanline->perspectiveUV,
-		scanline->textureIntensity,
-		scanline->texture
-	);
+		if (isAlphaTested ? includeAlphaTested : includeOpaque) {
+			triangleScanline(scanline);
+		}
+	}
 }
 
 /**
- * Rasterizes a single line across a section of a filled triangle.
- * Since this function controls the loop which operates on the level
- * of individual pixels, it is the most performance-critical part
- * of the system, and care must be taken to ensure that it includes
- * no unnecessary work.
+ * Classifies a single tile against a triangle's edges as either
+ * empty, partially covered, or fully covered, and shades its
+ * covered pixels one tile row at a time. Since edge functions are
+ * linear, a tile lies entirely outside an edge when the edge value
+ * at its most favorable corner is negative, and entirely inside it
+ * when the value at its least favorable corner is non-negative.
+ * Tiles which the triangle cannot be nearer than at any point are
+ * rejected up front against the tile depth buffer.
  */
-void Rasterizer::triangleScanline(
-	int x1, int y1, int length,
-	const Range<Color>& color,
-	const Range<float>& inverseDepth,
-	const Range<Vec2>& perspectiveUV,
-	const Range<Vec3>& textureIntensity,
-	const TextureBuffer* texture
-) {
-	int start = FAST_MAX(x1, 0);
-	int end = FAST_MIN(x1 + length, width - 1);
-	int pixelIndexOffset = y1 * width;
+void Rasterizer::rasterizeTile(const TriangleSetup& setup, int setupIndex, int tileX, int tileY) {
+	constexpr int tileExtent = TILE_SIZE - 1;
+	bool isFullyCovered = true;
 
-	float i_depthStep = (inverseDepth.end - inverseDepth.start) / length;
-	float i_depth = inverseDepth.start + (float)(start - x1) * i_depthStep;
+	float cornerInverseDepth = setup.start.inverseDepth + setup.dx.inverseDepth * (tileX - setup.origin.x) + setup.dy.inverseDepth * (tileY - setup.origin.y);
+	float maxInverseDepth = cornerInverseDepth + FAST_MAX(setup.dx.inverseDepth, 0.0f) * tileExtent + FAST_MAX(setup.dy.inverseDepth, 0.0f) * tileExtent;
 
-	float progressStep = 1.0f / length;
-	float progress = (float)(start - x1) * progressStep;
+	if (FAST_MIN(maxInverseDepth, setup.maxInverseDepth) < tileDepthBuffer[(tileY / TILE_SIZE) * totalTileColumns + tileX / TILE_SIZE]) {
+		return;
+	}
 
-	if (texture != NULL) {
-		Uint32 currentColor = 0;
+	for (int i = 0; i < 3; i++) {
+		const TriangleEdge& edge = setup.edges[i];
+		long long cornerValue = edge.at(tileX, tileY);
+		long long maxValue = cornerValue + FAST_MAX(edge.a, 0) * tileExtent + FAST_MAX(edge.b, 0) * tileExtent;
+		long long minValue = cornerValue + FAST_MIN(edge.a, 0) * tileExtent + FAST_MIN(edge.b, 0) * tileExtent;
 
-		float averageDepth = (1.0f / inverseDepth.start + 1.0f / inverseDepth.end) / 2.0f;
-		int mipmapLevel = getMipmapLevel(averageDepth);
-		const ColorBuffer* mipmap = texture->getMipmap(mipmapLevel);
-		int textureSampleInterval = getTextureSampleInterval(length, averageDepth);
-		int textureSampleIntervalCounter = textureSampleInterval;
-		bool isTransparent = false;
+		if (maxValue < 0) {
+			return;
+		}
 
-		for (int x = start; x <= end; x++) {
-			int index = pixelIndexOffset + x;
+		if (minValue < 0) {
+			isFullyCovered = false;
+		}
+	}
 
-			if (depthBuffer[index] < i_depth) {
-				if (++textureSampleIntervalCounter > textureSampleInterval) {
-					textureSampleIntervalCounter = 0;
+	const TriangleEdge& e0 = setup.edges[0];
+	const TriangleEdge& e1 = setup.edges[1];
+	const TriangleEdge& e2 = setup.edges[2];
+	int tileRight = FAST_MIN(tileX + tileExtent, width - 1);
+	int tileBottom = FAST_MIN(tileY + tileExtent, height - 1);
+
+	for (int y = tileY; y <= tileBottom; y++) {
+		int x1 = tileX;
+		int x2 = tileRight;
+
+		if (!isFullyCovered) {
+			// Since triangles are convex, the covered pixels
+			// in each tile row form a single contiguous span
+			long long w0 = e0.at(tileX, y);
+			long long w1 = e1.at(tileX, y);
+			long long w2 = e2.at(tileX, y);
+
+			x1 = INT_MAX;
+			x2 = INT_MIN;
+
+			for (int x = tileX; x <= tileRight; x++) {
+				if ((w0 | w1 | w2) >= 0) {
+					x1 = FAST_MIN(x1, x);
+					x2 = x;
+				}
 
-					float depth = 1.0f / i_depth;
-					float u = Lerp::lerp(perspectiveUV.start.x, perspectiveUV.end.x, progress) * depth;
-					float v = Lerp::lerp(perspectiveUV.start.y, perspectiveUV.end.y, progress) * depth;
-					const Color& sample = texture->sample(u, v, mipmap);
+				w0 += e0.a;
+				w1 += e1.a;
+				w2 += e2.a;
+			}
 
-					isTransparent = sample.R == COLOR_TRANSPARENT.R && sample.G == COLOR_TRANSPARENT.G && sample.B == COLOR_TRANSPARENT.B;
+			if (x2 < x1) {
+				continue;
+			}
+		}
 
-					if (!isTransparent) {
-						float intensity_R = Lerp::lerp(textureIntensity.start.x, textureIntensity.end.x, progress);
-						float intensity_G = Lerp::lerp(textureIntensity.start.y, textureIntensity.end.y, progress);
-						float intensity_B = Lerp::lerp(textureIntensity.start.z, textureIntensity.end.z, progress);
+		triangleScanline(
+			x1, x2, y,
+			interpolateTriangleSetup(setup, x1, y),
+			setup.dx,
+			setup.texture,
+			setup.mipmap,
+			setup.textureSampleInterval,
+			setup.spanKernel,
+			setupIndex
+		);
+	}
+}
 
-						int R = (int)(sample.R * intensity_R);
-						int G = (int)(sample.G * intensity_G);
-						int B = (int)(sample.B * intensity_B);
+/**
+ * Rasterizes every triangle binned into a band, in dispatch order,
+ * walking the tiles covered by each triangle's screen bounds within
+ * the band. Bands are a whole number of tiles tall, so tiles never
+ * straddle two bands.
+ */
+void Rasterizer::rasterizeTileBand(const RasterBand& band, int bandIndex, bool includeOpaque, bool includeAlphaTested) {
+	int bandTop = bandIndex * RASTER_BAND_HEIGHT;
+	int bandBottom = bandTop + RASTER_BAND_HEIGHT - 1;
 
-						if (visibility < INT_MAX) {
-							float visibilityRatio = FAST_MIN(depth / visibility, 1.0f);
+	for (int setupIndex : band.triangleSetups) {
+		const TriangleSetup& setup = triangleSetups[setupIndex];
+		bool isAlphaTested = (setup.spanKernel & SPAN_ALPHA_TESTED) != 0;
 
-							R = Lerp::lerp(R, backgroundColor.R, visibilityRatio);
-							G = Lerp::lerp(G, backgroundColor.G, visibilityRatio);
-							B = Lerp::lerp(B, backgroundColor.B, visibilityRatio);
-						}
+		if (isAlphaTested ? !includeAlphaTested : !includeOpaque) {
+			continue;
+		}
 
-						currentColor = ARGB(FAST_CLAMP(R, 0, 255), FAST_CLAMP(G, 0, 255), FAST_CLAMP(B, 0, 255));
-					}
-				}
+		int top = FAST_MAX(setup.topLeft.y, bandTop);
+		int bottom = FAST_MIN(setup.bottomRight.y, bandBottom);
+		int left = setup.topLeft.x - setup.topLeft.x % TILE_SIZE;
+		int right = setup.bottomRight.x;
 
-				if (!isTransparent) {
-					pixelBuffer[index] = currentColor;
+		for (int tileY = top - top % TILE_SIZE; tileY <= bottom; tileY += TILE_SIZE) {
+			for (int tileX = left; tileX <= right; tileX += TILE_SIZE) {
+				rasterizeTile(setup, setupIndex, tileX, tileY);
+			}
+		}
+	}
+}
+
+/**
+ * Shades every segment in a band's span buffer rows. Since segments
+ * never overlap, every covered pixel is shaded exactly once. Segment
+ * depths are still written to the depth buffer, so that alpha-tested
+ * triangles can later be depth tested against the resolved segments.
+ */
+void Rasterizer::resolveSpanBufferBand(int bandIndex) {
+	RasterBand& band = bands[bandIndex];
+	int top = bandIndex * RASTER_BAND_HEIGHT;
+	int bottom = FAST_MIN(top + RASTER_BAND_HEIGHT, height);
+
+	for (int y = top; y < bottom; y++) {
+		std::vector<SpanSegment>& segments = band.spanSegments[y - top];
+		int pixelIndexOffset = y * pitch;
+
+		if (segments.empty()) {
+			continue;
+		}
+
+		refreshRowDepth(y);
+
+		for (const SpanSegment& segment : segments) {
+			const TriangleSetup& setup = triangleSetups[segment.triangleSetup];
+			float i_depth = segment.inverseDepth;
+
+			for (int x = segment.start; x <= segment.end; x++) {
+				depthBuffer[pixelIndexOffset + x] = i_depth;
+				i_depth += segment.inverseDepthStep;
+			}
+
+			(this->*resolveKernels[setup.spanKernel])(setup, segment.start, segment.end, y);
+
+			updateTileDepth(segment.start, segment.end, y);
+		}
+
+		segments.clear();
+	}
+}
+
+/**
+ * Shades every pixel written to the visibility buffer within a band,
+ * once all of the band's triangles have been rasterized. Consecutive
+ * pixels sharing a triangle ID are shaded together as a single run.
+ * IDs are reset as they are resolved, so the visibility buffer never
+ * needs to be cleared separately.
+ */
+void Rasterizer::resolveVisibilityBand(int bandIndex) {
+	int top = bandIndex * RASTER_BAND_HEIGHT;
+	int bottom = FAST_MIN(top + RASTER_BAND_HEIGHT, height);
+
+	for (int y = top; y < bottom; y++) {
+		Uint32* row = &visibilityBuffer[y * pitch];
+
+		for (int x = 0; x < width;) {
+			Uint32 triangleId = row[x];
+
+			if (triangleId == 0) {
+				x++;
+
+				continue;
+			}
+
+			int start = x;
+
+			while (x < width && row[x] == triangleId) {
+				row[x++] = 0;
+			}
+
+			const TriangleSetup& setup = triangleSetups[triangleId - 1];
+
+			(this->*resolveKernels[setup.spanKernel])(setup, start, x - 1, y);
+		}
+	}
+}
+
+/**
+ * Shades pixels start through end (inclusive) of a screen row, all
+ * of which are covered by the same triangle in the visibility buffer.
+ * Attributes, including depth, are evaluated from the triangle setup
+ * rather than read back from the depth buffer, so only triangle IDs
+ * are read back at all. Alpha-tested textures are sampled per pixel,
+ * since their visible pixels may not be contiguous texels.
+ */
+template<int spanKernel>
+void Rasterizer::resolveVisibilityRun(const TriangleSetup& setup, int start, int end, int y) {
+	constexpr bool isTextured = (spanKernel & SPAN_TEXTURED) != 0;
+	constexpr bool isFogged = (spanKernel & SPAN_FOGGED) != 0;
+	constexpr bool isAlphaTested = (spanKernel & SPAN_ALPHA_TESTED) != 0;
+	constexpr bool isLit = (spanKernel & SPAN_LIT) != 0;
+	constexpr bool isSubdivided = (spanKernel & SPAN_SUBDIVIDED) != 0;
+	constexpr bool isPowerOfTwo = (spanKernel & SPAN_POWER_OF_TWO) != 0;
+
+	int pixelIndexOffset = y * pitch;
+	const Interpolants values = interpolateTriangleSetup(setup, start, y);
+	const Interpolants& step = setup.dx;
+
+	if constexpr (isTextured) {
+		const TextureBuffer* texture = setup.texture;
+		const ColorBuffer* mipmap = setup.mipmap;
+		int textureSampleInterval = isAlphaTested ? 0 : setup.textureSampleInterval;
+		int textureSampleIntervalCounter = textureSampleInterval;
+		Uint32 currentColor = 0;
+		bool hasColor = !isAlphaTested;
+
+		float i_depth = values.inverseDepth;
+		float perspectiveU = values.perspectiveUV.x;
+		float perspectiveV = values.perspectiveUV.y;
+		float intensity_R = values.textureIntensity.x;
+		float intensity_G = values.textureIntensity.y;
+		float intensity_B = values.textureIntensity.z;
+		AffineTextureSpan affineSpan;
+
+		for (int x = start; x <= end; x++) {
+			int index = pixelIndexOffset + x;
+
+			if (isSubdivided || ++textureSampleIntervalCounter > textureSampleInterval) {
+				textureSampleIntervalCounter = 0;
+
+				float depth;
+				Uint32 texel;
+
+				if constexpr (isSubdivided) {
+					int offset = x - start;
+
+					if (offset % perspectiveSpanLength == 0) {
+						affineSpan.subdivide(values, step, offset, FAST_MIN(offset + perspectiveSpanLength, end - start));
+
+						if constexpr (isPowerOfTwo) {
+							affineSpan.toFixedPoint(mipmap->width, mipmap->height);
+						}
+					}
+
+					int segmentOffset = offset - affineSpan.start;
+
+					depth = affineSpan.depth + affineSpan.depthStep * (float)segmentOffset;
+
+					if constexpr (isPowerOfTwo) {
+						texel = texture->samplePowerOfTwoUnchecked(
+							affineSpan.fixedU + affineSpan.fixedUStep * segmentOffset,
+							affineSpan.fixedV + affineSpan.fixedVStep * segmentOffset,
+							mipmap
+						);
+					} else {
+						float u = affineSpan.u + affineSpan.uStep * (float)segmentOffset;
+						float v = affineSpan.v + affineSpan.vStep * (float)segmentOffset;
+
+						texel = texture->sampleUnchecked(u, v, mipmap);
+					}
+				} else {
+					depth = 1.0f / i_depth;
+					texel = texture->sampleUnchecked(perspectiveU * depth, perspectiveV * depth, mipmap);
+				}
+
+				// Rounding may rarely land a visible pixel on a
+				// transparent texel, in which case the last
+				// opaque sample is reused, or the next one if
+				// no opaque sample has been taken yet
+				bool isTransparent = isAlphaTested && texel == TEXEL_TRANSPARENT;
+
+				if (!isTransparent) {
+					if constexpr (isLit || isFogged) {
+						int R = (texel >> 16) & 0xFF;
+						int G = (texel >> 8) & 0xFF;
+						int B = texel & 0xFF;
+
+						if constexpr (isLit) {
+							R = (int)(R * intensity_R);
+							G = (int)(G * intensity_G);
+							B = (int)(B * intensity_B);
+						}
+
+						if constexpr (isFogged) {
+							float visibilityRatio = FAST_MIN(depth / visibility, 1.0f);
+
+							R = Lerp::lerp(R, backgroundColor.R, visibilityRatio);
+							G = Lerp::lerp(G, backgroundColor.G, visibilityRatio);
+							B = Lerp::lerp(B, backgroundColor.B, visibilityRatio);
+						}
+
+						if constexpr (isLit) {
+							R = FAST_CLAMP(R, 0, 255);
+							G = FAST_CLAMP(G, 0, 255);
+							B = FAST_CLAMP(B, 0, 255);
+						}
+
+						currentColor = ARGB(R, G, B);
+					} else {
+						// Texels are stored packed, so unshaded
+						// samples can be written as they are
+						currentColor = texel;
+					}
+
+					if constexpr (isAlphaTested) {
+						if (!hasColor) {
+							for (int i = start; i < x; i++) {
+								pixelBuffer[pixelIndexOffset + i] = currentColor;
+							}
+
+							hasColor = true;
+						}
+					}
+				}
+			}
+
+			if (hasColor) {
+				pixelBuffer[index] = currentColor;
+			}
+
+			i_depth += step.inverseDepth;
+			perspectiveU += step.perspectiveUV.x;
+			perspectiveV += step.perspectiveUV.y;
+
+			if constexpr (isLit) {
+				intensity_R += step.textureIntensity.x;
+				intensity_G += step.textureIntensity.y;
+				intensity_B += step.textureIntensity.z;
+			}
+		}
+	} else {
+		float R = values.color.x;
+		float G = values.color.y;
+		float B = values.color.z;
+
+		for (int x = start; x <= end; x++) {
+			pixelBuffer[pixelIndexOffset + x] = ARGB(FAST_CLAMP((int)R, 0, 255), FAST_CLAMP((int)G, 0, 255), FAST_CLAMP((int)B, 0, 255));
+
+			R += step.color.x;
+			G += step.color.y;
+			B += step.color.z;
+		}
+	}
+}
+
+/**
+ * Clears a row's depth values if they were last cleared in a previous
+ * depth epoch. Rows are only ever drawn to by the worker rendering
+ * their band, so no synchronization is needed.
+ */
+void Rasterizer::refreshRowDepth(int y) {
+	if (rowDepthEpochs[y] != depthEpoch) {
+		clearRowDepth(y);
+	}
+}
+
+/**
+ * Presents the most recently cleared framebuffer, once all of its
+ * bands have been rasterized.
+ */
+void Rasterizer::render(SDL_Renderer* renderer, int sizeFactor) {
+	renderFramebuffer(renderer, framebuffers[currentFramebuffer], sizeFactor);
+}
+
+void Rasterizer::renderFramebuffer(SDL_Renderer* renderer, Framebuffer& framebuffer, int sizeFactor) {
+	SDL_Rect sourceRect = { 0, 0, framebuffer.width, framebuffer.height };
+	SDL_Rect destinationRect = { offset.x, offset.y, sizeFactor * bufferWidth, sizeFactor * bufferHeight };
+
+	if (framebuffer.isLocked) {
+		SDL_UnlockTexture(framebuffer.texture);
+
+		framebuffer.isLocked = false;
+	} else if (!framebuffer.isStreaming) {
+		SDL_UpdateTexture(framebuffer.texture, &sourceRect, framebuffer.pixels, framebuffer.pitch * sizeof(Uint32));
+	}
+
+	SDL_RenderCopy(renderer, framebuffer.texture, &sourceRect, &destinationRect);
+}
+
+/**
+ * Presents the framebuffer cleared before the most recent one. This
+ * allows a finished frame to be presented while the next frame is
+ * still being rasterized into the current framebuffer, at the cost of
+ * one frame of latency.
+ */
+void Rasterizer::renderPreviousFrame(SDL_Renderer* renderer, int sizeFactor) {
+	int previousFramebuffer = (currentFramebuffer + TOTAL_FRAMEBUFFERS - 1) % TOTAL_FRAMEBUFFERS;
+
+	renderFramebuffer(renderer, framebuffers[previousFramebuffer], sizeFactor);
+}
+
+/**
+ * Returns the next free Scanline in the band containing screen
+ * row y, claiming a new block from the Scanline store whenever
+ * the band's most recent block has been filled. Blocks are only
+ * allocated once every previously allocated block is in use, and
+ * are retained across frames, so the store grows to match the
+ * heaviest frame rendered so far rather than the screen size.
+ */
+Scanline* Rasterizer::requestScanline(int y) {
+	RasterBand& band = bands[y / RASTER_BAND_HEIGHT];
+	int blockOffset = band.totalScanlines % SCANLINE_BLOCK_SIZE;
+
+	if (blockOffset == 0) {
+		if (totalClaimedScanlineBlocks == (int)scanlineBlocks.size()) {
+			scanlineBlocks.push_back(new Scanline[SCANLINE_BLOCK_SIZE]);
+		}
+
+		band.blocks.push_back(scanlineBlocks[totalClaimedScanlineBlocks++]);
+	}
+
+	band.totalScanlines++;
+
+	return &band.blocks.back()[blockOffset];
+}
+
+void Rasterizer::setBackgroundColor(const Color& color) {
+	backgroundColor.R = color.R;
+	backgroundColor.G = color.G;
+	backgroundColor.B = color.B;
+}
+
+void Rasterizer::setBackgroundCovered(bool isBackgroundCovered) {
+	this->isBackgroundCovered = isBackgroundCovered;
+}
+
+void Rasterizer::setDepthEpochs(bool useDepthEpochs) {
+	this->useDepthEpochs = useDepthEpochs;
+}
+
+void Rasterizer::setDrawColor(Uint32 color) {
+	drawColor = color;
+}
+
+void Rasterizer::setDrawColor(int R, int G, int B) {
+	drawColor = ARGB(R, G, B);
+}
+
+void Rasterizer::setDrawColor(const Color& color) {
+	setDrawColor(color.R, color.G, color.B);
+}
+
+void Rasterizer::setOffset(const Coordinate& offset) {
+	this->offset.x = offset.x;
+	this->offset.y = offset.y;
+}
+
+/**
+ * Sets the number of pixels between exact perspective divides in
+ * subdivided texture spans, or disables span subdivision if 0. Span
+ * lengths are rounded down to a multiple of 8, so that vectorized
+ * kernels never have to straddle two segments in one iteration.
+ */
+void Rasterizer::setPerspectiveSpanLength(int perspectiveSpanLength) {
+	this->perspectiveSpanLength = perspectiveSpanLength > 0 ? FAST_MAX(perspectiveSpanLength & ~7, 8) : 0;
+}
+
+void Rasterizer::setRasterMode(RasterMode rasterMode) {
+	this->rasterMode = rasterMode;
+}
+
+/**
+ * Sets the resolution of the raster area within the rasterizer's
+ * buffers, which are allocated once at full size. The active raster
+ * area is always packed at the top left of each buffer, so that rows
+ * stay contiguous, and is stretched back to the full raster region
+ * when rendered. Must be called before clear(), since it changes the
+ * band layout and forces the depth buffer to be cleared.
+ */
+void Rasterizer::setResolution(int width, int height) {
+	width = FAST_CLAMP(width, 1, bufferWidth);
+	height = FAST_CLAMP(height, 1, bufferHeight);
+
+	if (width == this->width && height == this->height) {
+		return;
+	}
+
+	this->width = width;
+	this->height = height;
+
+	if (!hasStreamingTextures) {
+		pitch = width;
+	}
+
+	totalTileColumns = (width + TILE_SIZE - 1) / TILE_SIZE;
+	totalTileRows = (height + TILE_SIZE - 1) / TILE_SIZE;
+	totalBands = (height + RASTER_BAND_HEIGHT - 1) / RASTER_BAND_HEIGHT;
+}
+
+void Rasterizer::setShadingMode(ShadingMode shadingMode) {
+	this->shadingMode = shadingMode;
+}
+
+void Rasterizer::setPixel(int x, int y) {
+	int index = y * pitch + x;
+
+	pixelBuffer[index] = drawColor;
+}
+
+/**
+ * Computes a triangle's edge functions, clamped screen bounds, and
+ * attribute gradients, returning the index of the resulting setup,
+ * or -1 if the triangle is degenerate or entirely offscreen. The
+ * setup is shared by all spans and tiles of the triangle, so that
+ * its attributes are only ever interpolated once per triangle.
+ */
+int Rasterizer::setupTriangle(const Triangle& triangle) {
+	const Vertex2d* v0 = &triangle.vertices[0];
+	const Vertex2d* v1 = &triangle.vertices[1];
+	const Vertex2d* v2 = &triangle.vertices[2];
+	const Coordinate& c0 = v0->coordinate;
+
+	Coordinate d1 = { v1->coordinate.x - c0.x, v1->coordinate.y - c0.y };
+	Coordinate d2 = { v2->coordinate.x - c0.x, v2->coordinate.y - c0.y };
+	long long area = (long long)d1.x * d2.y - (long long)d2.x * d1.y;
+
+	if (area == 0) {
+		return -1;
+	}
+
+	if (area < 0) {
+		// Ensure a consistent winding order so that points
+		// inside the triangle are on the inner side of all
+		// three of its edges
+		swap(v1, v2);
+		swap(d1, d2);
+
+		area = -area;
+	}
+
+	const Coordinate& c1 = v1->coordinate;
+	const Coordinate& c2 = v2->coordinate;
+
+	int minX = FAST_MAX(FAST_MIN(c0.x, FAST_MIN(c1.x, c2.x)), 0);
+	int maxX = FAST_MIN(FAST_MAX(c0.x, FAST_MAX(c1.x, c2.x)), width - 1);
+	int minY = FAST_MAX(FAST_MIN(c0.y, FAST_MIN(c1.y, c2.y)), 0);
+	int maxY = FAST_MIN(FAST_MAX(c0.y, FAST_MAX(c1.y, c2.y)), height - 1);
+
+	if (minX > maxX || minY > maxY) {
+		return -1;
+	}
+
+	const TextureBuffer* texture = triangle.sourcePolygon->sourceObject->texture;
+	float inverseArea = 1.0f / area;
+
+	triangleSetups.emplace_back();
+
+	TriangleSetup& setup = triangleSetups.back();
+
+	setup.edges[0] = createTriangleEdge(c0, c1);
+	setup.edges[1] = createTriangleEdge(c1, c2);
+	setup.edges[2] = createTriangleEdge(c2, c0);
+	setup.origin = c0;
+	setup.topLeft = { minX, minY };
+	setup.bottomRight = { maxX, maxY };
+	setup.texture = texture;
+
+	setup.start.inverseDepth = v0->inverseDepth;
+	setup.maxInverseDepth = FAST_MAX(v0->inverseDepth, FAST_MAX(v1->inverseDepth, v2->inverseDepth));
+	computeGradient(v0->inverseDepth, v1->inverseDepth, v2->inverseDepth, d1, d2, inverseArea, setup.dx.inverseDepth, setup.dy.inverseDepth);
+
+	if (texture != NULL) {
+		float averageDepth = (v0->z + v1->z + v2->z) / 3.0f;
+
+		// Select the triangle's mipmap once for all of its spans, from
+		// the ratio of the texture area it covers to its screen area,
+		// which accounts for texture size, UV density, and orientation
+		float u0 = v0->perspectiveUV.x / v0->inverseDepth;
+		float u1 = v1->perspectiveUV.x / v1->inverseDepth;
+		float u2 = v2->perspectiveUV.x / v2->inverseDepth;
+		float t0 = v0->perspectiveUV.y / v0->inverseDepth;
+		float t1 = v1->perspectiveUV.y / v1->inverseDepth;
+		float t2 = v2->perspectiveUV.y / v2->inverseDepth;
+		float texelArea = fabs((u1 - u0) * (t2 - t0) - (u2 - u0) * (t1 - t0)) * texture->width * texture->height;
+
+		setup.mipmap = texture->getMipmap(getMipmapLevel(texelArea * inverseArea));
+		setup.textureSampleInterval = getTextureSampleInterval(maxX - minX + 1, averageDepth);
+
+		setup.start.perspectiveUV = v0->perspectiveUV;
+		computeGradient(v0->perspectiveUV.x, v1->perspectiveUV.x, v2->perspectiveUV.x, d1, d2, inverseArea, setup.dx.perspectiveUV.x, setup.dy.perspectiveUV.x);
+		computeGradient(v0->perspectiveUV.y, v1->perspectiveUV.y, v2->perspectiveUV.y, d1, d2, inverseArea, setup.dx.perspectiveUV.y, setup.dy.perspectiveUV.y);
+
+		setup.start.textureIntensity = v0->textureIntensity;
+		computeGradient(v0->textureIntensity.x, v1->textureIntensity.x, v2->textureIntensity.x, d1, d2, inverseArea, setup.dx.textureIntensity.x, setup.dy.textureIntensity.x);
+		computeGradient(v0->textureIntensity.y, v1->textureIntensity.y, v2->textureIntensity.y, d1, d2, inverseArea, setup.dx.textureIntensity.y, setup.dy.textureIntensity.y);
+		computeGradient(v0->textureIntensity.z, v1->textureIntensity.z, v2->textureIntensity.z, d1, d2, inverseArea, setup.dx.textureIntensity.z, setup.dy.textureIntensity.z);
+	} else {
+		setup.mipmap = NULL;
+		setup.textureSampleInterval = 1;
+
+		setup.start.color = { (float)v0->color.R, (float)v0->color.G, (float)v0->color.B };
+		computeGradient(v0->color.R, v1->color.R, v2->color.R, d1, d2, inverseArea, setup.dx.color.x, setup.dy.color.x);
+		computeGradient(v0->color.G, v1->color.G, v2->color.G, d1, d2, inverseArea, setup.dx.color.y, setup.dy.color.y);
+		computeGradient(v0->color.B, v1->color.B, v2->color.B, d1, d2, inverseArea, setup.dx.color.z, setup.dy.color.z);
+	}
+
+	setup.spanKernel = getSpanKernel(triangle, setup.mipmap);
+
+	return triangleSetups.size() - 1;
+}
+
+void Rasterizer::setSkyboxView(const SkyboxView& skyboxView) {
+	this->skyboxView = skyboxView;
+}
+
+void Rasterizer::setVisibility(int visibility) {
+	this->visibility = visibility;
+}
+
+/**
+ * Shades every pixel within a band which is still uncovered after
+ * the band's triangles have been rasterized, sampling the skybox in
+ * the view direction through the pixel. This way, the skybox never
+ * has to be projected, clipped or depth tested like other geometry,
+ * and none of it is overdrawn. Uncovered pixels are those with no
+ * depth written this frame: either every pixel of a row whose depth
+ * epoch stamp is stale, since nothing has drawn to the row yet, or
+ * pixels whose depth is still at the cleared value of 0.
+ */
+void Rasterizer::shadeSkyboxBand(int bandIndex) {
+	int top = bandIndex * RASTER_BAND_HEIGHT;
+	int bottom = FAST_MIN(top + RASTER_BAND_HEIGHT, height);
+	const ColorBuffer* mipmap = skyboxView.texture->getMipmap(0);
+	bool isFogged = visibility < INT_MAX;
+
+	for (int y = top; y < bottom; y++) {
+		int pixelIndexOffset = y * pitch;
+		Vec3 rowDirection = skyboxView.direction + skyboxView.yStep * (float)y;
+		bool isRowUncovered = rowDepthEpochs[y] != depthEpoch;
+
+		for (int x = 0; x < width; x++) {
+			int index = pixelIndexOffset + x;
+
+			if (isRowUncovered || depthBuffer[index] <= 0.0f) {
+				Vec3 direction = rowDirection + skyboxView.xStep * (float)x;
+				Uint32 texel = sampleSkybox(mipmap, direction);
+
+				if (isFogged) {
+					// Fogged like skybox geometry would be at the depth
+					// its faces are met at, which also fades out parts
+					// of the skybox beyond the visibility limit entirely
+					float depth = skyboxView.distance / FAST_MAX(fabsf(direction.x), FAST_MAX(fabsf(direction.y), fabsf(direction.z)));
+					float visibilityRatio = FAST_MIN(depth / visibility, 1.0f);
+
+					texel = ARGB(
+						Lerp::lerp((int)((texel >> 16) & 0xFF), backgroundColor.R, visibilityRatio),
+						Lerp::lerp((int)((texel >> 8) & 0xFF), backgroundColor.G, visibilityRatio),
+						Lerp::lerp((int)(texel & 0xFF), backgroundColor.B, visibilityRatio)
+					);
+				}
+
+				pixelBuffer[index] = texel;
+			}
+		}
+	}
+}
+
+void Rasterizer::triangle(int x1, int y1, int x2, int y2, int x3, int y3) {
+	line(x1, y1, x2, y2);
+	line(x2, y2, x3, y3);
+	line(x3, y3, x1, y1);
+}
+
+void Rasterizer::triangleScanline(const Scanline* scanline) {
+	const TriangleSetup& setup = triangleSetups[scanline->triangleSetup];
+	const TextureBuffer* texture = setup.texture;
+	const ColorBuffer* mipmap = NULL;
+	int textureSampleInterval = 1;
+	Interpolants values;
+
+	values.inverseDepth = scanline->inverseDepth;
+
+	if (texture != NULL) {
+		float endInverseDepth = scanline->inverseDepth + setup.dx.inverseDepth * scanline->length;
+		float averageDepth = (1.0f / scanline->inverseDepth + 1.0f / endInverseDepth) / 2.0f;
+
+		mipmap = setup.mipmap;
+		textureSampleInterval = getTextureSampleInterval(scanline->length, averageDepth);
+
+		values.perspectiveUV = scanline->texturing.perspectiveUV;
+		values.textureIntensity = scanline->texturing.textureIntensity;
+	} else {
+		values.color = scanline->color;
+	}
+
+	triangleScanline(
+		scanline->x, scanline->x + scanline->length, scanline->y,
+		values, setup.dx,
+		texture, mipmap, textureSampleInterval,
+		setup.spanKernel,
+		scanline->triangleSetup
+	);
+}
+
+/**
+ * Rasterizes a single line across a section of a filled triangle,
+ * from x1 to x2 (inclusive), given the triangle's attribute values
+ * at x1 and their per-pixel step. The line is first split into the
+ * segments falling within each screen tile, and segments which are
+ * nowhere nearer than the farthest depth already written to their
+ * tile are skipped with a single comparison, leaving only runs of
+ * potentially visible segments to be rasterized pixel by pixel.
+ * In deferred shading mode, runs only write depth and the ID of
+ * their triangle setup to the visibility buffer.
+ */
+void Rasterizer::triangleScanline(
+	int x1, int x2, int y,
+	const Interpolants& values,
+	const Interpolants& step,
+	const TextureBuffer* texture,
+	const ColorBuffer* mipmap,
+	int textureSampleInterval,
+	int spanKernel,
+	int setupIndex
+) {
+	int start = FAST_MAX(x1, 0);
+	int end = FAST_MIN(x2, width - 1);
+	const float* tileDepths = &tileDepthBuffer[(y / TILE_SIZE) * totalTileColumns];
+	SpanKernel triangleScanlineRun = spanKernels[spanKernel];
+	int runStart = start;
+
+	if (shadingMode == ShadingMode::SPAN_BUFFER && !(spanKernel & SPAN_ALPHA_TESTED)) {
+		bands[y / RASTER_BAND_HEIGHT].totalSpans[spanKernel]++;
+
+		if (start <= end) {
+			insertSpanSegment({ start, end, values.inverseDepth + step.inverseDepth * (start - x1), step.inverseDepth, setupIndex }, y);
+		}
+
+		return;
+	}
+
+	refreshRowDepth(y);
+
+	auto rasterizeRun = [&](int first, int last) {
+		if (shadingMode == ShadingMode::DEFERRED) {
+			Uint32 triangleId = setupIndex + 1;
+
+			if (spanKernel & SPAN_ALPHA_TESTED) {
+				triangleScanlineVisibilityRun<true>(x1, first, last, y, values, step, texture, mipmap, triangleId);
+			} else {
+				triangleScanlineVisibilityRun<false>(x1, first, last, y, values, step, texture, mipmap, triangleId);
+			}
+		} else {
+			(this->*triangleScanlineRun)(x1, x2, first, last, y, values, step, texture, mipmap, textureSampleInterval);
+		}
+
+		updateTileDepth(first, last, y);
+	};
+
+	bands[y / RASTER_BAND_HEIGHT].totalSpans[spanKernel]++;
+
+	for (int x = start; x <= end;) {
+		int tileColumn = x / TILE_SIZE;
+		int segmentEnd = FAST_MIN((tileColumn + 1) * TILE_SIZE - 1, end);
+		float startInverseDepth = values.inverseDepth + step.inverseDepth * (x - x1);
+		float endInverseDepth = values.inverseDepth + step.inverseDepth * (segmentEnd - x1);
+
+		if (FAST_MAX(startInverseDepth, endInverseDepth) < tileDepths[tileColumn]) {
+			if (runStart < x) {
+				rasterizeRun(runStart, x - 1);
+			}
+
+			runStart = segmentEnd + 1;
+		}
+
+		x = segmentEnd + 1;
+	}
+
+	if (runStart <= end) {
+		rasterizeRun(runStart, end);
+	}
+}
+
+/**
+ * Rasterizes pixels start through end (inclusive) of a line across
+ * a filled triangle spanning x1 to x2. Since this function controls
+ * the loop which operates on the level of individual pixels, it is
+ * the most performance-critical part of the system, and care must
+ * be taken to ensure that it includes no unnecessary work. Feature
+ * checks are resolved at compile time for each SpanKernelFeatures
+ * permutation, leaving only the depth test and sampling interval
+ * to be evaluated per pixel.
+ */
+template<int spanKernel>
+void Rasterizer::triangleScanlineRun(
+	int x1, int x2, int start, int end, int y,
+	const Interpolants& values,
+	const Interpolants& step,
+	const TextureBuffer* texture,
+	const ColorBuffer* mipmap,
+	int textureSampleInterval
+) {
+	constexpr bool isTextured = (spanKernel & SPAN_TEXTURED) != 0;
+	constexpr bool isFogged = (spanKernel & SPAN_FOGGED) != 0;
+	constexpr bool isAlphaTested = (spanKernel & SPAN_ALPHA_TESTED) != 0;
+	constexpr bool isLit = (spanKernel & SPAN_LIT) != 0;
+	constexpr bool isSubdivided = (spanKernel & SPAN_SUBDIVIDED) != 0;
+	constexpr bool isPowerOfTwo = (spanKernel & SPAN_POWER_OF_TWO) != 0;
+
+	// Subdivided spans are split into segments starting from the
+	// beginning of the run, including any part of the run handled
+	// by the vectorized kernel
+	int runStart = start;
+
+#if defined(__AVX2__)
+	int vectorLength = (end - start + 1) & ~7;
+
+	if (vectorLength > 0) {
+		triangleScanlineRunAVX2<spanKernel>(x1, x2, start, start + vectorLength - 1, y, values, step, mipmap, textureSampleInterval);
+
+		start += vectorLength;
+
+		if (start > end) {
+			return;
+		}
+	}
+#endif
+
+	int pixelIndexOffset = y * pitch;
+	float startOffset = (float)(start - x1);
+
+	float i_depthStep = step.inverseDepth;
+	float i_depth = values.inverseDepth + startOffset * i_depthStep;
+
+	if constexpr (isTextured) {
+		Uint32 currentColor = 0;
+		int textureSampleIntervalCounter = textureSampleInterval;
+		bool isTransparent = false;
+
+		float perspectiveU = values.perspectiveUV.x + startOffset * step.perspectiveUV.x;
+		float perspectiveV = values.perspectiveUV.y + startOffset * step.perspectiveUV.y;
+		float intensity_R = values.textureIntensity.x + startOffset * step.textureIntensity.x;
+		float intensity_G = values.textureIntensity.y + startOffset * step.textureIntensity.y;
+		float intensity_B = values.textureIntensity.z + startOffset * step.textureIntensity.z;
+		AffineTextureSpan affineSpan;
+
+		for (int x = start; x <= end; x++) {
+			int index = pixelIndexOffset + x;
+
+			if (depthBuffer[index] < i_depth) {
+				if (isSubdivided || ++textureSampleIntervalCounter > textureSampleInterval) {
+					textureSampleIntervalCounter = 0;
+
+					float depth;
+					Uint32 texel;
+
+					if constexpr (isSubdivided) {
+						int offset = x - x1;
+
+						if (offset >= affineSpan.end) {
+							int segmentStart = offset - (x - runStart) % perspectiveSpanLength;
+
+							affineSpan.subdivide(values, step, segmentStart, FAST_MIN(segmentStart + perspectiveSpanLength, x2 - x1));
+
+							if constexpr (isPowerOfTwo) {
+								affineSpan.toFixedPoint(mipmap->width, mipmap->height);
+							}
+						}
+
+						int segmentOffset = offset - affineSpan.start;
+
+						depth = affineSpan.depth + affineSpan.depthStep * (float)segmentOffset;
+
+						if constexpr (isPowerOfTwo) {
+							texel = texture->samplePowerOfTwoUnchecked(
+								affineSpan.fixedU + affineSpan.fixedUStep * segmentOffset,
+								affineSpan.fixedV + affineSpan.fixedVStep * segmentOffset,
+								mipmap
+							);
+						} else {
+							float u = affineSpan.u + affineSpan.uStep * (float)segmentOffset;
+							float v = affineSpan.v + affineSpan.vStep * (float)segmentOffset;
+
+							texel = texture->sampleUnchecked(u, v, mipmap);
+						}
+					} else {
+						depth = 1.0f / i_depth;
+						texel = texture->sampleUnchecked(perspectiveU * depth, perspectiveV * depth, mipmap);
+					}
+
+					if constexpr (isAlphaTested) {
+						isTransparent = texel == TEXEL_TRANSPARENT;
+					}
+
+					if constexpr (isLit || isFogged) {
+						int R = (texel >> 16) & 0xFF;
+						int G = (texel >> 8) & 0xFF;
+						int B = texel & 0xFF;
+
+						if constexpr (isLit) {
+							R = (int)(R * intensity_R);
+							G = (int)(G * intensity_G);
+							B = (int)(B * intensity_B);
+						}
+
+						if constexpr (isFogged) {
+							float visibilityRatio = FAST_MIN(depth / visibility, 1.0f);
+
+							R = Lerp::lerp(R, backgroundColor.R, visibilityRatio);
+							G = Lerp::lerp(G, backgroundColor.G, visibilityRatio);
+							B = Lerp::lerp(B, backgroundColor.B, visibilityRatio);
+						}
+
+						if constexpr (isLit) {
+							// Unlit texels and their fogged counterparts are
+							// always within range, but lighting may overflow
+							R = FAST_CLAMP(R, 0, 255);
+							G = FAST_CLAMP(G, 0, 255);
+							B = FAST_CLAMP(B, 0, 255);
+						}
+
+						currentColor = ARGB(R, G, B);
+					} else {
+						// Texels are stored packed, so unshaded
+						// samples can be written as they are
+						currentColor = texel;
+					}
+				}
+
+				if (!isAlphaTested || !isTransparent) {
+					pixelBuffer[index] = currentColor;
 					depthBuffer[index] = i_depth;
 				}
 			}
 
-			progress += progressStep;
 			i_depth += i_depthStep;
+			perspectiveU += step.perspectiveUV.x;
+			perspectiveV += step.perspectiveUV.y;
+
+			if constexpr (isLit) {
+				intensity_R += step.textureIntensity.x;
+				intensity_G += step.textureIntensity.y;
+				intensity_B += step.textureIntensity.z;
+			}
 		}
 	} else {
-		int colorLerpInterval = getColorLerpInterval(color.start, color.end, length);
+		int length = x2 - x1;
+		Color startColor = { (int)values.color.x, (int)values.color.y, (int)values.color.z };
+		Color endColor = { (int)(values.color.x + step.color.x * length), (int)(values.color.y + step.color.y * length), (int)(values.color.z + step.color.z * length) };
+		int colorLerpInterval = getColorLerpInterval(startColor, endColor, length);
 		int colorLerpIntervalCounter = colorLerpInterval;
 
+		float R = values.color.x + startOffset * step.color.x;
+		float G = values.color.y + startOffset * step.color.y;
+		float B = values.color.z + startOffset * step.color.z;
+
 		if (colorLerpInterval > 5) {
 			int chunkXLimit = end + 1;
 			int index = pixelIndexOffset + start;
-
-			progressStep *= colorLerpInterval;
+			float chunkStep_R = step.color.x * colorLerpInterval;
+			float chunkStep_G = step.color.y * colorLerpInterval;
+			float chunkStep_B = step.color.z * colorLerpInterval;
 
 			for (int x = start; x <= end; x += colorLerpInterval) {
-				int R = Lerp::lerp(color.start.R, color.end.R, progress);
-				int G = Lerp::lerp(color.start.G, color.end.G, progress);
-				int B = Lerp::lerp(color.start.B, color.end.B, progress);
-
 				int cx2 = FAST_MIN(x + colorLerpInterval, chunkXLimit);
-				Uint32 color = ARGB(R, G, B);
+				Uint32 color = ARGB((int)R, (int)G, (int)B);
 
 				for (int cx = x; cx < cx2; cx++) {
 					if (depthBuffer[index] < i_depth) {
@@ -428,7 +1752,9 @@ void Rasterizer::triangleScanline(
 					i_depth += i_depthStep;
 				}
 
-				progress += progressStep;
+				R += chunkStep_R;
+				G += chunkStep_G;
+				B += chunkStep_B;
 			}
 		} else {
 			Uint32 currentColor = 0;
@@ -438,11 +1764,7 @@ void Rasterizer::triangleScanline(
 
 				if (depthBuffer[index] < i_depth) {
 					if (++colorLerpIntervalCounter > colorLerpInterval || x == end) {
-						int R = Lerp::lerp(color.start.R, color.end.R, progress);
-						int G = Lerp::lerp(color.start.G, color.end.G, progress);
-						int B = Lerp::lerp(color.start.B, color.end.B, progress);
-
-						currentColor = ARGB(R, G, B);
+						currentColor = ARGB((int)R, (int)G, (int)B);
 						colorLerpIntervalCounter = 0;
 					}
 
@@ -450,8 +1772,395 @@ void Rasterizer::triangleScanline(
 					depthBuffer[index] = i_depth;
 				}
 
-				progress += progressStep;
 				i_depth += i_depthStep;
+				R += step.color.x;
+				G += step.color.y;
+				B += step.color.z;
+			}
+		}
+	}
+}
+
+#if defined(__AVX2__)
+/**
+ * Wraps a vector of texture coordinates into the [0, 1] range,
+ * matching the scalar wrapping in TextureBuffer::sample().
+ */
+static inline __m256 wrapTextureCoordinates(__m256 t) {
+	const __m256 one = _mm256_set1_ps(1.0f);
+	__m256 wrappedHigh = _mm256_sub_ps(t, _mm256_round_ps(t, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+	__m256 wrappedLow = _mm256_add_ps(t, _mm256_round_ps(_mm256_sub_ps(one, t), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+
+	t = _mm256_blendv_ps(t, wrappedHigh, _mm256_cmp_ps(t, one, _CMP_GE_OQ));
+	t = _mm256_blendv_ps(t, wrappedLow, _mm256_cmp_ps(t, _mm256_setzero_ps(), _CMP_LT_OQ));
+
+	return t;
+}
+
+/**
+ * Returns the offset from a run's first pixel to the first pixel
+ * of the group each lane belongs to, for groups of a fixed size
+ * starting at the beginning of the run. Biasing run offsets by
+ * one half keeps the reciprocal multiplication from falling just
+ * short of whole multiples of the group size.
+ */
+static inline __m256 getGroupOffsets(__m256 runOffsets, float groupSize) {
+	const __m256 half = _mm256_set1_ps(0.5f);
+	__m256 groups = _mm256_floor_ps(_mm256_mul_ps(_mm256_add_ps(runOffsets, half), _mm256_set1_ps(1.0f / groupSize)));
+
+	return _mm256_mul_ps(groups, _mm256_set1_ps(groupSize));
+}
+
+/**
+ * Evaluates an attribute with the given value at x1 and per-pixel
+ * step at a vector of offsets from x1.
+ */
+static inline __m256 interpolate(float value, float step, __m256 offsets) {
+	return _mm256_add_ps(_mm256_set1_ps(value), _mm256_mul_ps(_mm256_set1_ps(step), offsets));
+}
+
+/**
+ * Clamps and packs vectors of R, G, and B channels into ARGB pixels.
+ */
+static inline __m256i packColors(__m256i R, __m256i G, __m256i B) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i max = _mm256_set1_epi32(255);
+
+	R = _mm256_min_epi32(_mm256_max_epi32(R, zero), max);
+	G = _mm256_min_epi32(_mm256_max_epi32(G, zero), max);
+	B = _mm256_min_epi32(_mm256_max_epi32(B, zero), max);
+
+	__m256i color = _mm256_or_si256(_mm256_slli_epi32(R, 16), _mm256_slli_epi32(G, 8));
+
+	return _mm256_or_si256(_mm256_or_si256(color, B), _mm256_set1_epi32(255 << 24));
+}
+
+/**
+ * Vectorized counterpart to the scalar loops in triangleScanlineRun(),
+ * rasterizing 8 pixels per iteration. The number of pixels from start
+ * through end must be a multiple of 8.
+ *
+ * Rather than sampling textures or recomputing colors once every so
+ * many pixels which pass the depth test, as the scalar loops do, each
+ * lane evaluates its attributes at the first pixel of its fixed-size
+ * group along the run, which produces equivalent results without any
+ * dependency between lanes. Subdivided kernels sample every pixel,
+ * with segments aligned to the start of the run.
+ */
+template<int spanKernel>
+void Rasterizer::triangleScanlineRunAVX2(
+	int x1, int x2, int start, int end, int y,
+	const Interpolants& values,
+	const Interpolants& step,
+	const ColorBuffer* mipmap,
+	int textureSampleInterval
+) {
+	constexpr bool isTextured = (spanKernel & SPAN_TEXTURED) != 0;
+	constexpr bool isFogged = (spanKernel & SPAN_FOGGED) != 0;
+	constexpr bool isAlphaTested = (spanKernel & SPAN_ALPHA_TESTED) != 0;
+	constexpr bool isLit = (spanKernel & SPAN_LIT) != 0;
+	constexpr bool isSubdivided = (spanKernel & SPAN_SUBDIVIDED) != 0;
+	constexpr bool isPowerOfTwo = (spanKernel & SPAN_POWER_OF_TWO) != 0;
+
+	const __m256 laneOffsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	float* depths = &depthBuffer[y * pitch];
+	Uint32* pixels = &pixelBuffer[y * pitch];
+	float startOffset = (float)(start - x1);
+
+	if constexpr (isTextured) {
+		const int* texels = (const int*)mipmap->getBuffer();
+		const __m256 mipmapWidth = _mm256_set1_ps((float)mipmap->width);
+		const __m256 mipmapHeight = _mm256_set1_ps((float)mipmap->height);
+		const __m256i mipmapStride = _mm256_set1_epi32(mipmap->getStride());
+		const __m256i tileMask = _mm256_set1_epi32(3);
+		const __m256i widthMask = _mm256_set1_epi32(mipmap->width - 1);
+		const __m256i heightMask = _mm256_set1_epi32(mipmap->height - 1);
+		const __m256i fixedLaneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		bool isTiled = mipmap->getLayout() == TextureLayout::TILED;
+		const __m256i transparentTexel = _mm256_set1_epi32((int)TEXEL_TRANSPARENT);
+		const __m256i channelMask = _mm256_set1_epi32(0xFF);
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 inverseVisibility = _mm256_set1_ps(1.0f / visibility);
+		const __m256 backgroundR = _mm256_set1_ps((float)backgroundColor.R);
+		const __m256 backgroundG = _mm256_set1_ps((float)backgroundColor.G);
+		const __m256 backgroundB = _mm256_set1_ps((float)backgroundColor.B);
+		float groupSize = (float)(textureSampleInterval + 1);
+		AffineTextureSpan affineSpan;
+
+		for (int x = start; x <= end; x += 8) {
+			__m256 runOffsets = _mm256_add_ps(_mm256_set1_ps((float)(x - start)), laneOffsets);
+			__m256 pixelOffsets = _mm256_add_ps(runOffsets, _mm256_set1_ps(startOffset));
+			__m256 i_depth = interpolate(values.inverseDepth, step.inverseDepth, pixelOffsets);
+			__m256 passMask = _mm256_cmp_ps(_mm256_loadu_ps(&depths[x]), i_depth, _CMP_LT_OQ);
+
+			if (_mm256_movemask_ps(passMask) == 0) {
+				continue;
+			}
+
+			__m256 sampleOffsets;
+			__m256 depth;
+			__m256i texelX;
+			__m256i texelY;
+
+			if constexpr (isSubdivided) {
+				// Segments are a multiple of 8 pixels long, so each
+				// iteration falls entirely within a single segment
+				int offset = x - x1;
+
+				if (offset >= affineSpan.end) {
+					int segmentStart = offset - (x - start) % perspectiveSpanLength;
+
+					affineSpan.subdivide(values, step, segmentStart, FAST_MIN(segmentStart + perspectiveSpanLength, x2 - x1));
+
+					if constexpr (isPowerOfTwo) {
+						affineSpan.toFixedPoint(mipmap->width, mipmap->height);
+					}
+				}
+
+				int segmentOffset = offset - affineSpan.start;
+				__m256 segmentOffsets = _mm256_add_ps(_mm256_set1_ps((float)segmentOffset), laneOffsets);
+
+				sampleOffsets = pixelOffsets;
+				depth = interpolate(affineSpan.depth, affineSpan.depthStep, segmentOffsets);
+
+				if constexpr (isPowerOfTwo) {
+					// Matches TextureBuffer::samplePowerOfTwoUnchecked()
+					__m256i fixedSegmentOffsets = _mm256_add_epi32(_mm256_set1_epi32(segmentOffset), fixedLaneOffsets);
+					__m256i fixedU = _mm256_add_epi32(_mm256_set1_epi32(affineSpan.fixedU), _mm256_mullo_epi32(fixedSegmentOffsets, _mm256_set1_epi32(affineSpan.fixedUStep)));
+					__m256i fixedV = _mm256_add_epi32(_mm256_set1_epi32(affineSpan.fixedV), _mm256_mullo_epi32(fixedSegmentOffsets, _mm256_set1_epi32(affineSpan.fixedVStep)));
+
+					texelX = _mm256_and_si256(_mm256_srai_epi32(fixedU, TEXEL_FIXED_POINT_SHIFT), widthMask);
+					texelY = _mm256_and_si256(_mm256_srai_epi32(fixedV, TEXEL_FIXED_POINT_SHIFT), heightMask);
+				} else {
+					__m256 u = wrapTextureCoordinates(interpolate(affineSpan.u, affineSpan.uStep, segmentOffsets));
+					__m256 v = wrapTextureCoordinates(interpolate(affineSpan.v, affineSpan.vStep, segmentOffsets));
+
+					texelX = _mm256_cvttps_epi32(_mm256_mul_ps(u, mipmapWidth));
+					texelY = _mm256_cvttps_epi32(_mm256_mul_ps(v, mipmapHeight));
+				}
+			} else {
+				sampleOffsets = _mm256_add_ps(getGroupOffsets(runOffsets, groupSize), _mm256_set1_ps(startOffset));
+				depth = _mm256_div_ps(one, interpolate(values.inverseDepth, step.inverseDepth, sampleOffsets));
+
+				__m256 u = wrapTextureCoordinates(_mm256_mul_ps(interpolate(values.perspectiveUV.x, step.perspectiveUV.x, sampleOffsets), depth));
+				__m256 v = wrapTextureCoordinates(_mm256_mul_ps(interpolate(values.perspectiveUV.y, step.perspectiveUV.y, sampleOffsets), depth));
+
+				texelX = _mm256_cvttps_epi32(_mm256_mul_ps(u, mipmapWidth));
+				texelY = _mm256_cvttps_epi32(_mm256_mul_ps(v, mipmapHeight));
+			}
+
+			__m256i texelIndex;
+
+			if (isTiled) {
+				// Matches ColorBuffer::getTexelIndex() for 4x4 tiles
+				__m256i tileIndex = _mm256_add_epi32(
+					_mm256_mullo_epi32(_mm256_srli_epi32(texelY, 2), mipmapStride),
+					_mm256_srli_epi32(texelX, 2)
+				);
+
+				texelIndex = _mm256_or_si256(
+					_mm256_slli_epi32(tileIndex, 4),
+					_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(texelY, tileMask), 2), _mm256_and_si256(texelX, tileMask))
+				);
+			} else {
+				texelIndex = _mm256_add_epi32(_mm256_mullo_epi32(texelY, mipmapStride), texelX);
+			}
+
+			// Wrapped coordinates always land on a texel or one of
+			// the mipmap's guard texels, as in ColorBuffer::readUnchecked()
+			__m256i samples = _mm256_i32gather_epi32(texels, texelIndex, 4);
+			__m256i writeMask = _mm256_castps_si256(passMask);
+
+			if constexpr (isAlphaTested) {
+				writeMask = _mm256_andnot_si256(_mm256_cmpeq_epi32(samples, transparentTexel), writeMask);
+
+				if (_mm256_testz_si256(writeMask, writeMask)) {
+					continue;
+				}
+			}
+
+			if constexpr (!isLit && !isFogged) {
+				_mm256_maskstore_epi32((int*)&pixels[x], writeMask, samples);
+				_mm256_maskstore_ps(&depths[x], writeMask, i_depth);
+
+				continue;
+			}
+
+			__m256 R = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(samples, 16), channelMask));
+			__m256 G = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(samples, 8), channelMask));
+			__m256 B = _mm256_cvtepi32_ps(_mm256_and_si256(samples, channelMask));
+
+			if constexpr (isLit) {
+				R = _mm256_round_ps(_mm256_mul_ps(R, interpolate(values.textureIntensity.x, step.textureIntensity.x, sampleOffsets)), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+				G = _mm256_round_ps(_mm256_mul_ps(G, interpolate(values.textureIntensity.y, step.textureIntensity.y, sampleOffsets)), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+				B = _mm256_round_ps(_mm256_mul_ps(B, interpolate(values.textureIntensity.z, step.textureIntensity.z, sampleOffsets)), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+			}
+
+			if constexpr (isFogged) {
+				__m256 visibilityRatio = _mm256_min_ps(_mm256_mul_ps(depth, inverseVisibility), one);
+
+				R = _mm256_add_ps(R, _mm256_mul_ps(_mm256_sub_ps(backgroundR, R), visibilityRatio));
+				G = _mm256_add_ps(G, _mm256_mul_ps(_mm256_sub_ps(backgroundG, G), visibilityRatio));
+				B = _mm256_add_ps(B, _mm256_mul_ps(_mm256_sub_ps(backgroundB, B), visibilityRatio));
+			}
+
+			__m256i color = packColors(_mm256_cvttps_epi32(R), _mm256_cvttps_epi32(G), _mm256_cvttps_epi32(B));
+
+			_mm256_maskstore_epi32((int*)&pixels[x], writeMask, color);
+			_mm256_maskstore_ps(&depths[x], writeMask, i_depth);
+		}
+	} else {
+		int length = x2 - x1;
+		Color startColor = { (int)values.color.x, (int)values.color.y, (int)values.color.z };
+		Color endColor = { (int)(values.color.x + step.color.x * length), (int)(values.color.y + step.color.y * length), (int)(values.color.z + step.color.z * length) };
+		int colorLerpInterval = getColorLerpInterval(startColor, endColor, length);
+		float groupSize = (float)(colorLerpInterval > 5 ? colorLerpInterval : 1);
+
+		for (int x = start; x <= end; x += 8) {
+			__m256 runOffsets = _mm256_add_ps(_mm256_set1_ps((float)(x - start)), laneOffsets);
+			__m256 pixelOffsets = _mm256_add_ps(runOffsets, _mm256_set1_ps(startOffset));
+			__m256 i_depth = interpolate(values.inverseDepth, step.inverseDepth, pixelOffsets);
+			__m256i writeMask = _mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps(&depths[x]), i_depth, _CMP_LT_OQ));
+
+			if (_mm256_testz_si256(writeMask, writeMask)) {
+				continue;
+			}
+
+			__m256 colorOffsets = _mm256_add_ps(getGroupOffsets(runOffsets, groupSize), _mm256_set1_ps(startOffset));
+
+			__m256i color = packColors(
+				_mm256_cvttps_epi32(interpolate(values.color.x, step.color.x, colorOffsets)),
+				_mm256_cvttps_epi32(interpolate(values.color.y, step.color.y, colorOffsets)),
+				_mm256_cvttps_epi32(interpolate(values.color.z, step.color.z, colorOffsets))
+			);
+
+			_mm256_maskstore_epi32((int*)&pixels[x], writeMask, color);
+			_mm256_maskstore_ps(&depths[x], writeMask, i_depth);
+		}
+	}
+}
+#endif
+
+/**
+ * Maps a set of SpanKernelFeatures flags to the kernel permutation
+ * which handles them. Untextured kernels are unaffected by the
+ * remaining features, and share a single permutation, while power-
+ * of-two textures only have a separate path in subdivided kernels.
+ */
+constexpr int Rasterizer::getSpanKernelPermutation(int spanKernel) {
+	if ((spanKernel & SPAN_TEXTURED) == 0) {
+		return 0;
+	}
+
+	if ((spanKernel & SPAN_SUBDIVIDED) == 0) {
+		return spanKernel & ~SPAN_POWER_OF_TWO;
+	}
+
+	return spanKernel;
+}
+
+template<size_t... spanKernel>
+constexpr std::array<Rasterizer::ResolveKernel, TOTAL_SPAN_KERNELS> Rasterizer::createResolveKernels(std::index_sequence<spanKernel...>) {
+	return { &Rasterizer::resolveVisibilityRun<getSpanKernelPermutation(spanKernel)>... };
+}
+
+template<size_t... spanKernel>
+constexpr std::array<Rasterizer::SpanKernel, TOTAL_SPAN_KERNELS> Rasterizer::createSpanKernels(std::index_sequence<spanKernel...>) {
+	return { &Rasterizer::triangleScanlineRun<getSpanKernelPermutation(spanKernel)>... };
+}
+
+/**
+ * Span kernel permutations, indexed by SpanKernelFeatures flags.
+ */
+const std::array<Rasterizer::SpanKernel, TOTAL_SPAN_KERNELS> Rasterizer::spanKernels = Rasterizer::createSpanKernels(std::make_index_sequence<TOTAL_SPAN_KERNELS>());
+const std::array<Rasterizer::ResolveKernel, TOTAL_SPAN_KERNELS> Rasterizer::resolveKernels = Rasterizer::createResolveKernels(std::make_index_sequence<TOTAL_SPAN_KERNELS>());
+
+/**
+ * Writes depth and a triangle ID for each visible pixel from start
+ * through end (inclusive) of a line across a filled triangle, for
+ * shading once all triangles have been rasterized. Alpha-tested
+ * triangles still need to sample their textures to determine which
+ * pixels they cover, but no other shading is done.
+ */
+template<bool isAlphaTested>
+void Rasterizer::triangleScanlineVisibilityRun(
+	int x1, int start, int end, int y,
+	const Interpolants& values,
+	const Interpolants& step,
+	const TextureBuffer* texture,
+	const ColorBuffer* mipmap,
+	Uint32 triangleId
+) {
+	int pixelIndexOffset = y * pitch;
+	float startOffset = (float)(start - x1);
+
+	float i_depthStep = step.inverseDepth;
+	float i_depth = values.inverseDepth + startOffset * i_depthStep;
+	float perspectiveU = values.perspectiveUV.x + startOffset * step.perspectiveUV.x;
+	float perspectiveV = values.perspectiveUV.y + startOffset * step.perspectiveUV.y;
+
+	for (int x = start; x <= end; x++) {
+		int index = pixelIndexOffset + x;
+
+		if (depthBuffer[index] < i_depth) {
+			bool isTransparent = false;
+
+			if constexpr (isAlphaTested) {
+				float depth = 1.0f / i_depth;
+				isTransparent = !texture->isOpaqueUnchecked(perspectiveU * depth, perspectiveV * depth, mipmap);
+			}
+
+			if (!isTransparent) {
+				depthBuffer[index] = i_depth;
+				visibilityBuffer[index] = triangleId;
+			}
+		}
+
+		i_depth += i_depthStep;
+
+		if constexpr (isAlphaTested) {
+			perspectiveU += step.perspectiveUV.x;
+			perspectiveV += step.perspectiveUV.y;
+		}
+	}
+}
+
+/**
+ * Raises the farthest inverse depth recorded for each tile row
+ * segment touched by pixels start through end of screen row y,
+ * and for their tiles, to reflect newly written depth values.
+ * Since depth values only ever move nearer between clears, the
+ * recorded values never need to be lowered.
+ */
+void Rasterizer::updateTileDepth(int start, int end, int y) {
+	float* rowDepths = &tileRowDepthBuffer[y * totalTileColumns];
+	float* tileDepths = &tileDepthBuffer[(y / TILE_SIZE) * totalTileColumns];
+	int tileTop = y - y % TILE_SIZE;
+	int tileBottom = FAST_MIN(tileTop + TILE_SIZE, height);
+
+	for (int tileColumn = start / TILE_SIZE; tileColumn <= end / TILE_SIZE; tileColumn++) {
+		int tileLeft = tileColumn * TILE_SIZE;
+		int tileRight = FAST_MIN(tileLeft + TILE_SIZE, width);
+		const float* depths = &depthBuffer[y * pitch];
+		float rowDepth = depths[tileLeft];
+
+		for (int x = tileLeft + 1; x < tileRight; x++) {
+			rowDepth = FAST_MIN(rowDepth, depths[x]);
+		}
+
+		float previousRowDepth = rowDepths[tileColumn];
+
+		if (rowDepth > previousRowDepth) {
+			rowDepths[tileColumn] = rowDepth;
+
+			if (previousRowDepth == tileDepths[tileColumn]) {
+				float tileDepth = rowDepth;
+
+				for (int row = tileTop; row < tileBottom; row++) {
+					tileDepth = FAST_MIN(tileDepth, tileRowDepthBuffer[row * totalTileColumns + tileColumn]);
+				}
+
+				tileDepths[tileColumn] = tileDepth;
 			}
 		}
 	}
@@ -24,7 +24,7 @@ TextureBuffer::TextureBuffer(const char* file) {
 TextureBuffer::~TextureBuffer() {
 	if (mipmaps.size() > 0) {
 		// Free software texture memory
-		for (const auto* mipmap : mipmaps) {
+		for (auto* mipmap : mipmaps) {
 			delete mipmap;
 		}
 
@@ -35,6 +35,34 @@ TextureBuffer::~TextureBuffer() {
 	}
 }
 
+/**
+ * Classifies each of the texture's mipmaps as fully opaque or
+ * alpha-tested, and the texture as a whole as fully opaque,
+ * alpha-tested, or mixed if its mipmaps differ. Downsized mipmaps
+ * average their source texels, so transparent texels only survive
+ * into smaller mipmaps where they fill whole blocks of texels.
+ */
+void TextureBuffer::analyzeOpacity() {
+	bool hasOpaqueMipmaps = false;
+	bool hasAlphaTestedMipmaps = false;
+
+	for (auto* mipmap : mipmaps) {
+		mipmap->analyzeOpacity();
+
+		if (mipmap->getOpacity() == TextureOpacity::ALPHA_TESTED) {
+			hasAlphaTestedMipmaps = true;
+		} else {
+			hasOpaqueMipmaps = true;
+		}
+	}
+
+	opacity = (
+		!hasAlphaTestedMipmaps ? TextureOpacity::FULLY_OPAQUE :
+		!hasOpaqueMipmaps ? TextureOpacity::ALPHA_TESTED :
+		TextureOpacity::MIXED
+	);
+}
+
 void TextureBuffer::confirmTexture(SDL_Renderer* renderer, TextureMode mode) {
 	if (!isConfirmed) {
 		isConfirmed = true;
@@ -51,18 +79,27 @@ void TextureBuffer::confirmTexture(SDL_Renderer* renderer, TextureMode mode) {
 		height = image->h;
 		totalPixels = image->w * image->h;
 
+		// Mipmaps halve each dimension, so power-of-two textures
+		// have power-of-two dimensions at every mipmap level
+		isPowerOfTwo = (width & (width - 1)) == 0 && (height & (height - 1)) == 0;
+
 		if (mode == TextureMode::HARDWARE) {
 			texture = SDL_CreateTextureFromSurface(renderer, image);
 		} else if (mode == TextureMode::SOFTWARE) {
 			SDL_PixelFormat* format = image->format;
 			ColorBuffer* colorBuffer = new ColorBuffer(width, height);
 
+			colorBuffer->setLayout(layout);
+
 			for (int i = 0; i < totalPixels; i++) {
 				Uint32 color = TextureBuffer::readPixel(image, i);
 				int x = i % width;
 				int y = (int)(i / width);
+				int R = (color & 0x00FF0000) >> 16;
+				int G = (color & 0x0000FF00) >> 8;
+				int B = color & 0x000000FF;
 
-				colorBuffer->write(x, y, (color & 0x00FF0000) >> 16, (color & 0x0000FF00) >> 8, color & 0x000000FF);
+				colorBuffer->write(x, y, R, G, B);
 			}
 
 			mipmaps.push_back(colorBuffer);
@@ -77,12 +114,18 @@ void TextureBuffer::confirmTexture(SDL_Renderer* renderer, TextureMode mode) {
 					mipmaps.push_back(mipmap);
 				}
 			}
+
+			analyzeOpacity();
 		}
 
 		SDL_FreeSurface(image);
 	}
 }
 
+TextureLayout TextureBuffer::getLayout() const {
+	return layout;
+}
+
 const ColorBuffer* TextureBuffer::getMipmap(int level) const {
 	return level >= mipmaps.size() ? mipmaps.back() : mipmaps.at(level);
 }
@@ -106,19 +149,24 @@ Uint32 TextureBuffer::readPixel(SDL_Surface* surface, int index) {
 	return ARGB(R, G, B);
 }
 
-const Color& TextureBuffer::sample(float u, float v, const ColorBuffer* mipmap) const {
+Uint32 TextureBuffer::sample(float u, float v, const ColorBuffer* mipmap) const {
 	if (mipmaps.empty()) {
-		return COLOR_BLACK;
+		return ARGB(0, 0, 0);
 	}
 
-	// Modulo-free out-of-bounds UV wrapping
-	if (u >= 1.0f) u -= (int)u;
-	else if (u < 0.0f) u += (int)(-1.0f * (u - 1.0f));
-
-	if (v >= 1.0f) v -= (int)v;
-	else if (v < 0.0f) v += (int)(-1.0f * (v - 1.0f));
+	return sampleUnchecked(u, v, mipmap);
+}
 
-	int pixelIndex = (int)(v * (mipmap->height)) * mipmap->width + (int)(u * mipmap->width);
+/**
+ * Sets the layout of the texture's texels in memory. Textures
+ * which are already confirmed have each of their mipmaps
+ * rearranged; otherwise, mipmaps are created in the new layout
+ * once the texture is confirmed.
+ */
+void TextureBuffer::setLayout(TextureLayout layout) {
+	this->layout = layout;
 
-	return mipmap->read(pixelIndex);
+	for (auto* mipmap : mipmaps) {
+		mipmap->setLayout(layout);
+	}
 }
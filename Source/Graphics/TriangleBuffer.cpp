@@ -25,10 +25,18 @@
  *
  * In single-threaded mode, the pool/buffer swapping still occurs,
  * with virtually no cost, but no utility either.
+ *
+ * The active pool can further be divided into sub-pools, so that
+ * screen projection can be split across several threads, each
+ * requesting Triangles from its own sub-pool. The remainder of the
+ * pool is shared between sub-pools as overflow, which is claimed
+ * in chunks by any sub-pool running out of Triangles.
  */
 TriangleBuffer::TriangleBuffer() {
 	trianglePoolA = new Triangle[TRIANGLE_POOL_SIZE];
 	trianglePoolB = new Triangle[TRIANGLE_POOL_SIZE];
+
+	setTotalSubPools(1, TRIANGLE_POOL_SIZE);
 }
 
 TriangleBuffer::~TriangleBuffer() {
@@ -65,7 +73,13 @@ const std::vector<Triangle*>& TriangleBuffer::getBufferedTriangles() {
 }
 
 int TriangleBuffer::getTotalRequestedTriangles() {
-	return totalRequestedTriangles;
+	int total = 0;
+
+	for (const auto& subPool : subPools) {
+		total += subPool.totalRequestedTriangles;
+	}
+
+	return total;
 }
 
 int TriangleBuffer::getTotalNonStaticTriangles() {
@@ -80,15 +94,26 @@ int TriangleBuffer::getTotalNonStaticTriangles() {
 	return total;
 }
 
-Triangle* TriangleBuffer::requestTriangle() {
-	if (totalRequestedTriangles >= TRIANGLE_POOL_SIZE) {
-		Alert::error(ALERT_ERROR, "Triangle buffer overflow");
-		exit(0);
+Triangle* TriangleBuffer::requestTriangle(int subPoolIndex) {
+	SubPool& subPool = subPools[subPoolIndex];
+
+	if (subPool.next >= subPool.end) {
+		int chunkOffset = overflowOffset.fetch_add(TRIANGLE_OVERFLOW_CHUNK_SIZE, std::memory_order_relaxed);
+
+		if (chunkOffset >= TRIANGLE_POOL_SIZE) {
+			Alert::error(ALERT_ERROR, "Triangle buffer overflow");
+			exit(0);
+		}
+
+		subPool.next = chunkOffset;
+		subPool.end = FAST_MIN(chunkOffset + TRIANGLE_OVERFLOW_CHUNK_SIZE, TRIANGLE_POOL_SIZE);
 	}
 
 	Triangle* pool = isSwapped ? trianglePoolB : trianglePoolA;
 
-	return &pool[totalRequestedTriangles++];
+	subPool.totalRequestedTriangles++;
+
+	return &pool[subPool.next++];
 }
 
 /**
@@ -99,9 +124,10 @@ Triangle* TriangleBuffer::requestTriangle() {
  * screen-projected Triangles on the next frame.
  */
 void TriangleBuffer::reset() {
-	totalRequestedTriangles = 0;
 	isSwapped = !isSwapped;
 
+	resetSubPools();
+
 	auto& primaryBuffer = isSwapped ? triangleBufferB : triangleBufferA;
 
 	primaryBuffer.clear();
@@ -112,9 +138,45 @@ void TriangleBuffer::reset() {
  * and clearing both primary and secondary buffers.
  */
 void TriangleBuffer::resetAll() {
-	totalRequestedTriangles = 0;
 	isSwapped = false;
 
+	resetSubPools();
+
 	triangleBufferA.clear();
 	triangleBufferB.clear();
 }
+
+void TriangleBuffer::resetSubPools() {
+	for (auto& subPool : subPools) {
+		subPool.next = subPool.offset;
+		subPool.end = subPool.offset + subPool.size;
+		subPool.totalRequestedTriangles = 0;
+	}
+
+	overflowOffset.store(totalSubPools * subPoolSize, std::memory_order_relaxed);
+}
+
+/**
+ * Divides the active pool into equally sized sub-pools, each
+ * reserving an even share of the Triangles expected for the frame.
+ * The rest of the pool is left over as shared overflow, so that
+ * the pool only overflows once the frame's total Triangles exceed
+ * it, however unevenly they're requested between sub-pools. Since
+ * requested Triangles would otherwise be overwritten, this should
+ * only be done before any Triangles are requested on a frame.
+ */
+void TriangleBuffer::setTotalSubPools(int totalSubPools, int expectedTriangles) {
+	this->totalSubPools = totalSubPools;
+	subPoolSize = FAST_MIN((expectedTriangles + totalSubPools - 1) / totalSubPools, TRIANGLE_POOL_SIZE / totalSubPools);
+
+	subPools.resize(totalSubPools);
+
+	for (int i = 0; i < totalSubPools; i++) {
+		SubPool& subPool = subPools[i];
+
+		subPool.offset = i * subPoolSize;
+		subPool.size = subPoolSize;
+	}
+
+	resetSubPools();
+}
@@ -33,6 +33,10 @@ void Controller::exitScene() {
 	pendingSceneChange = SceneChange::EXIT_SCENE;
 }
 
+int Controller::getDrawTime() {
+	return engine->getDrawTime();
+}
+
 int Controller::getFlags() {
 	return engine->getFlags();
 }
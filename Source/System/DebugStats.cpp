@@ -1,5 +1,56 @@
 #include <System/DebugStats.h>
 #include <SDL.h>
+#include <new>
+#include <stdlib.h>
+
+/**
+ * The total number of heap allocations made through operator new
+ * since startup by the current thread, so that allocations made by
+ * render workers don't leak into counts for main thread stages.
+ * Allocation counts for a stage or a frame are the difference
+ * between its start and end totals.
+ */
+static thread_local int totalAllocations = 0;
+
+#if defined(TRACK_ALLOCATIONS)
+/**
+ * Replacing the global allocation functions affects everything
+ * linked into the program, so the counting hooks are only built
+ * when allocation tracking is enabled at compile time. Otherwise,
+ * allocation counts always read as zero.
+ */
+void* operator new(size_t size) {
+	totalAllocations++;
+
+	void* pointer = malloc(size > 0 ? size : 1);
+
+	if (pointer == NULL) {
+		throw std::bad_alloc();
+	}
+
+	return pointer;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+	free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+	free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+	free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+	free(pointer);
+}
+#endif
 
 /**
  * DebugStats
@@ -7,6 +58,7 @@
  */
 void DebugStats::trackScreenProjectionTime() {
 	screenProjectionTime.start = (int)SDL_GetTicks();
+	screenProjectionAllocations.start = totalAllocations;
 }
 
 void DebugStats::trackHiddenSurfaceRemovalTime() {
@@ -27,10 +79,12 @@ void DebugStats::trackUpdateTime() {
 
 void DebugStats::trackFrameTime() {
 	frameTime.start = (int)SDL_GetTicks();
+	frameAllocations.start = totalAllocations;
 }
 
 void DebugStats::logScreenProjectionTime() {
 	screenProjectionTime.end = (int)SDL_GetTicks();
+	screenProjectionAllocations.end = totalAllocations;
 }
 
 void DebugStats::logHiddenSurfaceRemovalTime() {
@@ -51,6 +105,7 @@ void DebugStats::logUpdateTime() {
 
 void DebugStats::logFrameTime() {
 	frameTime.end = (int)SDL_GetTicks();
+	frameAllocations.end = totalAllocations;
 }
 
 int DebugStats::getScreenProjectionTime() {
@@ -81,6 +136,14 @@ int DebugStats::getFPS() {
 	return (int)(1000.0f / getFrameTime());
 }
 
+int DebugStats::getFrameAllocations() {
+	return frameAllocations.end - frameAllocations.start;
+}
+
+int DebugStats::getScreenProjectionAllocations() {
+	return screenProjectionAllocations.end - screenProjectionAllocations.start;
+}
+
 void DebugStats::countPolygons(int polygons) {
 	totalPolygons += polygons;
 }
@@ -25,17 +25,6 @@ Vertex2d Vertex2d::lerp(const Vertex2d& v1, const Vertex2d& v2, float r) {
  * Vertex3d
  * --------
  */
-Vertex3d Vertex3d::lerp(const Vertex3d& v1, const Vertex3d& v2, float r) {
-	Vertex3d vertex;
-
-	vertex.vector = Vec3::lerp(v1.vector, v2.vector, r);
-	vertex.uv = Vec2::lerp(v1.uv, v2.uv, r);
-	vertex.color = Color::lerp(v1.color, v2.color, r);
-	vertex.normal = ((v1.normal + v2.normal) / 2.0f).unit();
-
-	return vertex;
-}
-
 void Vertex3d::morph(int startTarget, int endTarget, float progress) {
 	const Vec3& startVector = morphTargets.at(startTarget);
 	const Vec3& endVector = morphTargets.at(endTarget);
@@ -77,6 +66,21 @@ void Vertex3d::scale(const Vec3& scaleVector) {
 	}
 }
 
+/**
+ * ViewVertex
+ * ----------
+ */
+ViewVertex ViewVertex::lerp(const ViewVertex& v1, const ViewVertex& v2, float r) {
+	ViewVertex vertex;
+
+	vertex.vector = Vec3::lerp(v1.vector, v2.vector, r);
+	vertex.uv = Vec2::lerp(v1.uv, v2.uv, r);
+	vertex.color = Color::lerp(v1.color, v2.color, r);
+	vertex.normal = ((v1.normal + v2.normal) / 2.0f).unit();
+
+	return vertex;
+}
+
 /**
  * Triangle
  * --------
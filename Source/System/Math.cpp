@@ -66,6 +66,18 @@ RotationMatrix RotationMatrix::fromVec3(const Vec3& rotation) {
 	return rZ * rY * rX;
 }
 
+/**
+ * Returns the transpose of the matrix, which for a rotation
+ * matrix is also its inverse.
+ */
+RotationMatrix RotationMatrix::transpose() const {
+	return {
+		m11, m21, m31,
+		m12, m22, m32,
+		m13, m23, m33
+	};
+}
+
 Vec3 RotationMatrix::operator *(const Vec3& v) const {
 	return {
 		m11 * v.x + m12 * v.y + m13 * v.z,
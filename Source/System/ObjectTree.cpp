@@ -0,0 +1,461 @@
+#include <System/ObjectTree.h>
+#include <System/Objects.h>
+#include <System/Geometry.h>
+#include <System/Math.h>
+#include <Constants.h>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * ObjectTree
+ * ----------
+ *
+ * A dynamic bounding volume hierarchy over a Scene's Objects,
+ * allowing Objects overlapping a region, or hit by a ray, to be
+ * found without checking every Object individually. Objects are
+ * inserted with world space bounds, which are expanded by a
+ * margin, and only need to be reinserted when they move beyond
+ * that margin.
+ *
+ * Each Object is assigned a sequence number when it is inserted,
+ * and ordered query results are returned in that order, so that
+ * callers see Objects in the order they were added to the tree.
+ */
+int ObjectTree::allocateNode() {
+	if (freeNodes.empty()) {
+		nodes.push_back(Node());
+
+		return nodes.size() - 1;
+	}
+
+	int index = freeNodes.back();
+
+	freeNodes.pop_back();
+
+	nodes[index] = Node();
+
+	return index;
+}
+
+/**
+ * Rotates the taller child of a node up into its place if its
+ * children's heights differ by more than 1, returning the index
+ * of the node now in its place. Without rebalancing, Objects
+ * inserted with identical bounds, such as Particles which have
+ * yet to be spawned, would degrade the tree into a linked list.
+ */
+int ObjectTree::balance(int index) {
+	Node& a = nodes[index];
+
+	if (a.isLeaf() || a.height < 2) {
+		return index;
+	}
+
+	int indexB = a.children[0];
+	int indexC = a.children[1];
+	int difference = nodes[indexC].height - nodes[indexB].height;
+
+	if (difference >= -1 && difference <= 1) {
+		return index;
+	}
+
+	// Rotate the taller child up, handing its shorter
+	// grandchild down to the node it replaces
+	int side = difference > 1 ? 1 : 0;
+	int indexUp = a.children[side];
+	int indexOther = a.children[1 - side];
+	Node& up = nodes[indexUp];
+	int indexF = up.children[0];
+	int indexG = up.children[1];
+	int indexTaller = nodes[indexF].height > nodes[indexG].height ? indexF : indexG;
+	int indexShorter = indexTaller == indexF ? indexG : indexF;
+
+	up.children[0] = index;
+	up.children[1] = indexTaller;
+	up.parent = a.parent;
+	a.parent = indexUp;
+	a.children[side] = indexShorter;
+	nodes[indexShorter].parent = index;
+
+	if (up.parent == -1) {
+		root = indexUp;
+	} else {
+		Node& parent = nodes[up.parent];
+
+		parent.children[parent.children[0] == index ? 0 : 1] = indexUp;
+	}
+
+	a.bounds = combine(nodes[indexOther].bounds, nodes[indexShorter].bounds);
+	a.height = 1 + std::max(nodes[indexOther].height, nodes[indexShorter].height);
+	up.bounds = combine(a.bounds, nodes[indexTaller].bounds);
+	up.height = 1 + std::max(a.height, nodes[indexTaller].height);
+
+	return indexUp;
+}
+
+void ObjectTree::clear() {
+	nodes.clear();
+	freeNodes.clear();
+	leaves.clear();
+
+	root = -1;
+	nextSequence = 0;
+}
+
+Bounds ObjectTree::combine(const Bounds& a, const Bounds& b) {
+	Bounds bounds;
+
+	bounds.cornerA = {
+		std::min(a.cornerA.x, b.cornerA.x),
+		std::min(a.cornerA.y, b.cornerA.y),
+		std::min(a.cornerA.z, b.cornerA.z)
+	};
+
+	bounds.cornerB = {
+		std::max(a.cornerB.x, b.cornerB.x),
+		std::max(a.cornerB.y, b.cornerB.y),
+		std::max(a.cornerB.z, b.cornerB.z)
+	};
+
+	return bounds;
+}
+
+bool ObjectTree::contains(const Bounds& outer, const Bounds& inner) {
+	return (
+		inner.cornerA.x >= outer.cornerA.x && inner.cornerB.x <= outer.cornerB.x &&
+		inner.cornerA.y >= outer.cornerA.y && inner.cornerB.y <= outer.cornerB.y &&
+		inner.cornerA.z >= outer.cornerA.z && inner.cornerB.z <= outer.cornerB.z
+	);
+}
+
+Bounds ObjectTree::expand(const Bounds& bounds, float margin) {
+	Bounds expandedBounds;
+
+	expandedBounds.cornerA = bounds.cornerA - Vec3(margin, margin, margin);
+	expandedBounds.cornerB = bounds.cornerB + Vec3(margin, margin, margin);
+
+	return expandedBounds;
+}
+
+void ObjectTree::freeNode(int index) {
+	nodes[index].object = NULL;
+
+	freeNodes.push_back(index);
+}
+
+/**
+ * Returns the expanded bounds an Object was last inserted with,
+ * which enclose its current bounds.
+ */
+const Bounds& ObjectTree::getBounds(const Object* object) const {
+	return nodes[leaves.at(object)].bounds;
+}
+
+/**
+ * Returns the distance along a ray at which it enters a set of
+ * bounds, 0 if it starts inside them, or -1 if it misses them.
+ */
+float ObjectTree::getRayEntryDistance(const Bounds& bounds, const Vec3& origin, const Vec3& inverseDirection) {
+	float t1 = (bounds.cornerA.x - origin.x) * inverseDirection.x;
+	float t2 = (bounds.cornerB.x - origin.x) * inverseDirection.x;
+	float t3 = (bounds.cornerA.y - origin.y) * inverseDirection.y;
+	float t4 = (bounds.cornerB.y - origin.y) * inverseDirection.y;
+	float t5 = (bounds.cornerA.z - origin.z) * inverseDirection.z;
+	float t6 = (bounds.cornerB.z - origin.z) * inverseDirection.z;
+
+	float entry = std::max(std::max(std::min(t1, t2), std::min(t3, t4)), std::min(t5, t6));
+	float exit = std::min(std::min(std::max(t1, t2), std::max(t3, t4)), std::max(t5, t6));
+
+	if (exit < 0.0f || entry > exit) {
+		return -1.0f;
+	}
+
+	return std::max(entry, 0.0f);
+}
+
+float ObjectTree::getSurfaceArea(const Bounds& bounds) {
+	Vec3 size = bounds.cornerB - bounds.cornerA;
+
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+bool ObjectTree::has(const Object* object) const {
+	return leaves.find(object) != leaves.end();
+}
+
+void ObjectTree::insert(Object* object, const Bounds& bounds) {
+	int leaf = allocateNode();
+	Node& node = nodes[leaf];
+
+	node.bounds = expand(bounds, OBJECT_TREE_BOUNDS_MARGIN);
+	node.object = object;
+	node.sequence = nextSequence++;
+
+	leaves[object] = leaf;
+
+	insertLeaf(leaf);
+}
+
+/**
+ * Inserts a leaf node into the tree, pairing it with whichever
+ * sibling node minimizes the added surface area of the tree.
+ * Smaller branch surface areas make it less likely that queries
+ * have to descend into branches they don't overlap.
+ */
+void ObjectTree::insertLeaf(int leaf) {
+	if (root == -1) {
+		root = leaf;
+		nodes[root].parent = -1;
+
+		return;
+	}
+
+	Bounds leafBounds = nodes[leaf].bounds;
+	int index = root;
+
+	while (!nodes[index].isLeaf()) {
+		const Node& node = nodes[index];
+		float area = getSurfaceArea(node.bounds);
+		float combinedArea = getSurfaceArea(combine(node.bounds, leafBounds));
+
+		// Cost of pairing the leaf with this node, versus the
+		// minimum cost of pushing the leaf further down the tree
+		float cost = 2.0f * combinedArea;
+		float inheritanceCost = 2.0f * (combinedArea - area);
+		float childCosts[2];
+
+		for (int i = 0; i < 2; i++) {
+			const Node& child = nodes[node.children[i]];
+			float childArea = getSurfaceArea(combine(child.bounds, leafBounds));
+
+			if (!child.isLeaf()) {
+				childArea -= getSurfaceArea(child.bounds);
+			}
+
+			childCosts[i] = childArea + inheritanceCost;
+		}
+
+		if (cost < childCosts[0] && cost < childCosts[1]) {
+			break;
+		}
+
+		index = childCosts[0] < childCosts[1] ? node.children[0] : node.children[1];
+	}
+
+	int sibling = index;
+	int oldParent = nodes[sibling].parent;
+	int newParent = allocateNode();
+
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].bounds = combine(leafBounds, nodes[sibling].bounds);
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].children[0] = sibling;
+	nodes[newParent].children[1] = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent == -1) {
+		root = newParent;
+	} else {
+		Node& parent = nodes[oldParent];
+
+		parent.children[parent.children[0] == sibling ? 0 : 1] = newParent;
+	}
+
+	refitAncestors(newParent);
+}
+
+bool ObjectTree::Node::isLeaf() const {
+	return children[0] == -1;
+}
+
+/**
+ * Collects every Object whose bounds satisfy a predicate, skipping
+ * any branches whose bounds don't. The predicate must therefore be
+ * satisfied by any bounds enclosing other bounds which satisfy it,
+ * as is the case for overlap tests. Results are only sorted into
+ * insertion order if requested, since otherwise their order is
+ * left to the tree's shape.
+ */
+void ObjectTree::query(const BoundsPredicate& isOverlapping, std::vector<Object*>& objects, bool isOrdered) {
+	objects.clear();
+	results.clear();
+
+	if (root == -1) {
+		return;
+	}
+
+	stack.clear();
+	stack.push_back(root);
+
+	while (!stack.empty()) {
+		const Node& node = nodes[stack.back()];
+
+		stack.pop_back();
+
+		if (!isOverlapping(node.bounds)) {
+			continue;
+		}
+
+		if (!node.isLeaf()) {
+			stack.push_back(node.children[0]);
+			stack.push_back(node.children[1]);
+		} else if (isOrdered) {
+			results.push_back({ node.sequence, node.object });
+		} else {
+			objects.push_back(node.object);
+		}
+	}
+
+	if (!isOrdered) {
+		return;
+	}
+
+	std::sort(results.begin(), results.end(), [](const std::pair<int, Object*>& a, const std::pair<int, Object*>& b) {
+		return a.first < b.first;
+	});
+
+	for (const auto& result : results) {
+		objects.push_back(result.second);
+	}
+}
+
+/**
+ * Finds the nearest Object hit by a ray, skipping any branches the
+ * ray misses or only enters beyond the nearest hit found so far.
+ * Since bounds only approximate Objects, the exact hit distance
+ * for each Object is left to a handler.
+ */
+Object* ObjectTree::raycast(const Vec3& origin, const Vec3& direction, const RayHitHandler& getHitDistance) {
+	if (root == -1) {
+		return NULL;
+	}
+
+	// Avoid dividing by zero for rays parallel to any axis
+	auto getInverse = [](float value) {
+		return std::abs(value) < 1e-8f ? (value < 0.0f ? -1e8f : 1e8f) : 1.0f / value;
+	};
+
+	Vec3 inverseDirection = { getInverse(direction.x), getInverse(direction.y), getInverse(direction.z) };
+	Object* nearestObject = NULL;
+	float nearestDistance = 0.0f;
+
+	stack.clear();
+	stack.push_back(root);
+
+	while (!stack.empty()) {
+		const Node& node = nodes[stack.back()];
+
+		stack.pop_back();
+
+		float entryDistance = getRayEntryDistance(node.bounds, origin, inverseDirection);
+
+		if (entryDistance < 0.0f || (nearestObject != NULL && entryDistance > nearestDistance)) {
+			continue;
+		}
+
+		if (node.isLeaf()) {
+			float hitDistance = getHitDistance(node.object);
+
+			if (hitDistance >= 0.0f && (nearestObject == NULL || hitDistance < nearestDistance)) {
+				nearestObject = node.object;
+				nearestDistance = hitDistance;
+			}
+		} else {
+			stack.push_back(node.children[0]);
+			stack.push_back(node.children[1]);
+		}
+	}
+
+	return nearestObject;
+}
+
+/**
+ * Rebalances a node and each of its ancestors, and recomputes
+ * their bounds and heights from their children.
+ */
+void ObjectTree::refitAncestors(int index) {
+	while (index != -1) {
+		index = balance(index);
+
+		Node& node = nodes[index];
+		const Node& childA = nodes[node.children[0]];
+		const Node& childB = nodes[node.children[1]];
+
+		node.bounds = combine(childA.bounds, childB.bounds);
+		node.height = 1 + std::max(childA.height, childB.height);
+		index = node.parent;
+	}
+}
+
+void ObjectTree::remove(const Object* object) {
+	auto entry = leaves.find(object);
+
+	if (entry == leaves.end()) {
+		return;
+	}
+
+	int leaf = entry->second;
+
+	leaves.erase(entry);
+	removeLeaf(leaf);
+	freeNode(leaf);
+}
+
+/**
+ * Detaches a leaf node from the tree, replacing its parent
+ * with its sibling.
+ */
+void ObjectTree::removeLeaf(int leaf) {
+	if (leaf == root) {
+		root = -1;
+
+		return;
+	}
+
+	int parent = nodes[leaf].parent;
+	int grandparent = nodes[parent].parent;
+	int sibling = nodes[parent].children[0] == leaf ? nodes[parent].children[1] : nodes[parent].children[0];
+
+	if (grandparent == -1) {
+		root = sibling;
+		nodes[sibling].parent = -1;
+	} else {
+		Node& node = nodes[grandparent];
+
+		node.children[node.children[0] == parent ? 0 : 1] = sibling;
+		nodes[sibling].parent = grandparent;
+
+		refitAncestors(grandparent);
+	}
+
+	freeNode(parent);
+}
+
+/**
+ * Refits an Object's leaf to its current bounds, returning whether
+ * the leaf had to be reinserted. Leaves are only reinserted once the
+ * Object has moved beyond its expanded bounds, keeping its original
+ * sequence number.
+ */
+bool ObjectTree::update(const Object* object, const Bounds& bounds) {
+	auto entry = leaves.find(object);
+
+	if (entry == leaves.end()) {
+		return false;
+	}
+
+	int leaf = entry->second;
+
+	if (contains(nodes[leaf].bounds, bounds)) {
+		return false;
+	}
+
+	removeLeaf(leaf);
+
+	nodes[leaf].bounds = expand(bounds, OBJECT_TREE_BOUNDS_MARGIN);
+
+	insertLeaf(leaf);
+
+	return true;
+}
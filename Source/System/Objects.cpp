@@ -51,6 +51,16 @@ void Object::addMorphTarget(Object* morphTarget) {
 	// Free the original Object used as the morph target,
 	// since its vertices were the only information we needed
 	delete morphTarget;
+
+	updateBounds();
+}
+
+void Object::addNearbyLight(Light* light) {
+	nearbyLights.push_back(light);
+
+	for (auto* lod : lods) {
+		lod->nearbyLights.push_back(light);
+	}
 }
 
 void Object::addPolygon(int v1_index, int v2_index, int v3_index) {
@@ -116,12 +126,21 @@ void Object::applyRotationMatrix(const RotationMatrix& matrix) {
 	}
 
 	recomputeSurfaceNormals();
+	updateBounds();
 
 	for (auto* lod : lods) {
 		lod->applyRotationMatrix(matrix);
 	}
 }
 
+void Object::clearNearbyLights() {
+	nearbyLights.clear();
+
+	for (auto* lod : lods) {
+		lod->nearbyLights.clear();
+	}
+}
+
 Vec3 Object::computePolygonNormal(const Polygon& polygon) {
 	const Vec3* v0 = &polygon.vertices[0]->vector;
 	const Vec3* v1 = &polygon.vertices[1]->vector;
@@ -170,10 +189,32 @@ const Object* Object::getLOD(float distance) const {
 	return lods.at(lodIndex);
 }
 
+/**
+ * Returns the Object's bounding box, relative to its position.
+ */
+const Bounds& Object::getBounds() const {
+	return bounds;
+}
+
+/**
+ * Returns the Object's bounding sphere, relative to its position.
+ */
+const BoundingSphere& Object::getBoundingSphere() const {
+	return boundingSphere;
+}
+
 const std::vector<Object*>& Object::getLODs() const {
 	return lods;
 }
 
+/**
+ * Returns the Lights whose range overlaps the Object, as last
+ * assigned by its Scene, in the order they were added to it.
+ */
+const std::vector<Light*>& Object::getNearbyLights() const {
+	return nearbyLights;
+}
+
 int Object::getPolygonCount() const {
 	return polygons.size();
 }
@@ -224,6 +265,8 @@ void Object::scale(float scalar) {
 		vertex.scale(scalar);
 	}
 
+	updateBounds();
+
 	for (auto* lod : lods) {
 		lod->scale(scalar);
 	}
@@ -234,6 +277,8 @@ void Object::scale(const Vec3& vector) {
 		vertex.scale(vector);
 	}
 
+	updateBounds();
+
 	for (auto* lod : lods) {
 		lod->scale(vector);
 	}
@@ -316,6 +361,63 @@ void Object::syncLODs() {
 	}
 }
 
+/**
+ * Recomputes the Object's bounding box and bounding sphere from its
+ * vertices. Morph targets are included, so the bounds enclose every
+ * frame interpolated between them, and needn't be recomputed as the
+ * Object morphs.
+ */
+void Object::updateBounds() {
+	bounds = Bounds();
+	boundingSphere = BoundingSphere();
+
+	if (vertices.empty()) {
+		return;
+	}
+
+	Vec3 minimum = vertices.at(0).vector;
+	Vec3 maximum = minimum;
+
+	auto expandBounds = [&](const Vec3& vector) {
+		minimum.x = std::min(minimum.x, vector.x);
+		minimum.y = std::min(minimum.y, vector.y);
+		minimum.z = std::min(minimum.z, vector.z);
+		maximum.x = std::max(maximum.x, vector.x);
+		maximum.y = std::max(maximum.y, vector.y);
+		maximum.z = std::max(maximum.z, vector.z);
+	};
+
+	for (const auto& vertex : vertices) {
+		expandBounds(vertex.vector);
+
+		for (const auto& morphTarget : vertex.morphTargets) {
+			expandBounds(morphTarget);
+		}
+	}
+
+	Vec3 center = (minimum + maximum) * 0.5f;
+	float maxDistanceSquared = 0.0f;
+
+	auto expandRadius = [&](const Vec3& vector) {
+		Vec3 offset = vector - center;
+
+		maxDistanceSquared = std::max(maxDistanceSquared, Vec3::dotProduct(offset, offset));
+	};
+
+	for (const auto& vertex : vertices) {
+		expandRadius(vertex.vector);
+
+		for (const auto& morphTarget : vertex.morphTargets) {
+			expandRadius(morphTarget);
+		}
+	}
+
+	bounds.cornerA = minimum;
+	bounds.cornerB = maximum;
+	boundingSphere.center = center;
+	boundingSphere.radius = sqrtf(maxDistanceSquared);
+}
+
 void Object::update(int dt) {
 	updatePosition(dt);
 
@@ -451,6 +553,8 @@ Model::Model(const ObjLoader& obj) {
 			addPolygon(v1, v2, v3);
 		}
 	}
+
+	updateBounds();
 }
 
 /**
@@ -507,6 +611,8 @@ Mesh::Mesh(int rows, int columns, float tileSize) {
 			addPolygon(v1, v2, v3);
 		}
 	}
+
+	updateBounds();
 }
 
 void Mesh::setTextureInterval(int rowInterval, int columnInterval) {
@@ -543,6 +649,7 @@ void Mesh::setVertexOffsets(std::function<void(int, int, Vec3&)> offsetHandler)
 	}
 
 	recomputeSurfaceNormals();
+	updateBounds();
 }
 
 /**
@@ -570,6 +677,8 @@ Cube::Cube(float radius) {
 
 		addPolygon((*vertices)[0], (*vertices)[1], (*vertices)[2]);
 	}
+
+	updateBounds();
 }
 
 /**
@@ -677,6 +786,8 @@ Particle::Particle() {
 	addPolygon(0, 2, 1);
 	addPolygon(1, 2, 3);
 
+	updateBounds();
+
 	isFlatShaded = true;
 	canOccludeSurfaces = false;
 }
@@ -774,6 +885,33 @@ Skybox::Skybox(float size) {
 	nearClippingDistance = size / 10.0f;
 }
 
+/**
+ * Rotations are applied directly to an Object's vertices, so the
+ * Skybox's orientation is recovered from the edges leading out of
+ * its (-1, -1, -1) corner along each of its original axes. The
+ * returned matrix rotates world space directions back into the
+ * Skybox's unrotated space, in which its texture is laid out.
+ */
+RotationMatrix Skybox::getInverseRotationMatrix() const {
+	const Vec3& corner = vertices[0].vector;
+	Vec3 xAxis = (vertices[3].vector - corner).unit();
+	Vec3 yAxis = (vertices[4].vector - corner).unit();
+	Vec3 zAxis = (vertices[2].vector - corner).unit();
+
+	return {
+		xAxis.x, xAxis.y, xAxis.z,
+		yAxis.x, yAxis.y, yAxis.z,
+		zAxis.x, zAxis.y, zAxis.z
+	};
+}
+
+/**
+ * Returns the distance from the Skybox's center to each of its faces.
+ */
+float Skybox::getSize() const {
+	return (vertices[3].vector - vertices[0].vector).magnitude() / 2.0f;
+}
+
 void Skybox::setTexture(TextureBuffer* texture) {
 	texture->shouldUseMipmaps = false;
 
@@ -45,10 +45,17 @@ void Scene::add(Object* object) {
 	object->recomputeSurfaceNormals();
 
 	objects.push_back(object);
+	objectTree.insert(object, getObjectBounds(object));
 
 	if (object->isOfType<Light>()) {
 		lights.push_back((Light*)object);
+
+		shouldReassignLights = true;
+	} else if (object->isOfType<Skybox>()) {
+		skybox = (Skybox*)object;
 	}
+
+	addedObjects.push_back(object);
 }
 
 void Scene::add(Sound* sound) {
@@ -78,6 +85,38 @@ void Scene::add(const char* key, ParticleSystem* particleSystem) {
 
 	for (auto* particle : particleSystem->getParticles()) {
 		objects.push_back(particle);
+		objectTree.insert(particle, getObjectBounds(particle));
+		addedObjects.push_back(particle);
+	}
+}
+
+/**
+ * Assigns every Object the Lights whose range overlaps it, using
+ * one Object tree query per Light, and records the bounds of each
+ * Light so that later frames only need to revisit Objects near the
+ * Lights which moved.
+ */
+void Scene::assignNearbyLights() {
+	assignedLightBounds.clear();
+
+	for (auto* object : objects) {
+		object->clearNearbyLights();
+	}
+
+	// Each Object's nearby Lights are added in Scene order no matter
+	// which order Objects are found in, so results needn't be sorted
+	for (auto* light : lights) {
+		Bounds lightBounds = getLightBounds(light);
+
+		objectTree.query([&](const Bounds& bounds) {
+			return bounds.isColliding(lightBounds);
+		}, overlappingObjects, false);
+
+		for (auto* object : overlappingObjects) {
+			object->addNearbyLight(light);
+		}
+
+		assignedLightBounds.push_back(lightBounds);
 	}
 }
 
@@ -111,6 +150,15 @@ const Camera& Scene::getCamera() const {
 	return *camera;
 }
 
+/**
+ * Returns the world space bounds of a Light's range.
+ */
+Bounds Scene::getLightBounds(const Light* light) {
+	Vec3 range = { light->range, light->range, light->range };
+
+	return { light->position - range, light->position + range };
+}
+
 const std::vector<Light*>& Scene::getLights() {
 	return lights;
 }
@@ -119,6 +167,31 @@ Object* Scene::getObject(const char* key) {
 	return retrieveMappedEntity(objectMap, key);
 }
 
+/**
+ * Returns the world space bounds of an Object, enclosing each of
+ * its LODs as well, so that any one of them can be culled or
+ * illuminated using the Object's entry in the Object tree.
+ */
+Bounds Scene::getObjectBounds(const Object* object) {
+	Bounds bounds = object->getBounds();
+
+	for (const auto* lod : object->getLODs()) {
+		const Bounds& lodBounds = lod->getBounds();
+
+		bounds.cornerA.x = std::min(bounds.cornerA.x, lodBounds.cornerA.x);
+		bounds.cornerA.y = std::min(bounds.cornerA.y, lodBounds.cornerA.y);
+		bounds.cornerA.z = std::min(bounds.cornerA.z, lodBounds.cornerA.z);
+		bounds.cornerB.x = std::max(bounds.cornerB.x, lodBounds.cornerB.x);
+		bounds.cornerB.y = std::max(bounds.cornerB.y, lodBounds.cornerB.y);
+		bounds.cornerB.z = std::max(bounds.cornerB.z, lodBounds.cornerB.z);
+	}
+
+	bounds.cornerA += object->position;
+	bounds.cornerB += object->position;
+
+	return bounds;
+}
+
 const std::vector<Object*>& Scene::getObjects() {
 	return objects;
 }
@@ -135,6 +208,10 @@ int Scene::getRunningTime() {
 	return runningTime;
 }
 
+const Skybox* Scene::getSkybox() const {
+	return skybox;
+}
+
 Sound* Scene::getSound(const char* key) {
 	return retrieveMappedEntity(soundMap, key);
 }
@@ -212,6 +289,69 @@ bool Scene::isInCurrentOccupiedSector(int sectorId) {
 void Scene::onStart() {}
 void Scene::onUpdate(int dt) {}
 
+/**
+ * Returns the nearest Object hit by a ray, or NULL if the ray
+ * doesn't hit any Object. Ray hits are determined against each
+ * of an Object's polygons, regardless of which way they face.
+ * The Skybox is excluded, since it surrounds the camera.
+ */
+Object* Scene::pickObject(const Vec3& origin, const Vec3& direction) {
+	return objectTree.raycast(origin, direction, [&](const Object* object) {
+		float nearestDistance = -1.0f;
+
+		if (object == skybox) {
+			return nearestDistance;
+		}
+
+		for (const auto* polygon : object->getPolygons()) {
+			Vec3 v0 = object->position + polygon->vertices[0]->vector;
+			Vec3 edge1 = polygon->vertices[1]->vector - polygon->vertices[0]->vector;
+			Vec3 edge2 = polygon->vertices[2]->vector - polygon->vertices[0]->vector;
+			Vec3 p = Vec3::crossProduct(direction, edge2);
+			float determinant = Vec3::dotProduct(edge1, p);
+
+			if (std::abs(determinant) < 1e-8f) {
+				// Ray is parallel to the polygon
+				continue;
+			}
+
+			// Solve for the barycentric coordinates of the hit point,
+			// rejecting the polygon if they fall outside of it
+			float inverseDeterminant = 1.0f / determinant;
+			Vec3 t = origin - v0;
+			float u = Vec3::dotProduct(t, p) * inverseDeterminant;
+
+			if (u < 0.0f || u > 1.0f) {
+				continue;
+			}
+
+			Vec3 q = Vec3::crossProduct(t, edge1);
+			float v = Vec3::dotProduct(direction, q) * inverseDeterminant;
+
+			if (v < 0.0f || u + v > 1.0f) {
+				continue;
+			}
+
+			float distance = Vec3::dotProduct(edge2, q) * inverseDeterminant;
+
+			if (distance >= 0.0f && (nearestDistance < 0.0f || distance < nearestDistance)) {
+				nearestDistance = distance;
+			}
+		}
+
+		return nearestDistance;
+	});
+}
+
+/**
+ * Returns the nearest Object at the center of the camera's view.
+ * Since the mouse is captured in relative mode, this is the Object
+ * being pointed at, e.g. when handling mouse clicks.
+ */
+Object* Scene::pickObjectInView() {
+	return pickObject(camera->position, camera->getDirection());
+}
+
 void Scene::provideController(Controller* controller) {
 	this->controller = controller;
 }
@@ -220,6 +360,14 @@ void Scene::provideUI(UI* ui) {
 	this->ui = ui;
 }
 
+/**
+ * Collects the Objects whose bounds in the Object tree satisfy a
+ * predicate, in the order they were added to the Scene.
+ */
+void Scene::queryObjects(const BoundsPredicate& isOverlapping, std::vector<Object*>& objects) {
+	objectTree.query(isOverlapping, objects, true);
+}
+
 /**
  * Removes an entity by key, agnostic as to the entity type.
  * We invoke all routines for safely freeing mapped entities,
@@ -251,15 +399,45 @@ void Scene::removeExpiredObjects() {
 }
 
 /**
- * Removes an Object by reference from the Object pointer
- * list, and Light pointer list if applicable, before placing
- * it in the disposal queue for deferred deletion.
+ * Reassigns a single Object the Lights whose recorded range overlaps
+ * its bounds in the Object tree, in Scene order.
+ */
+void Scene::reassignNearbyLights(Object* object) {
+	const Bounds& bounds = objectTree.getBounds(object);
+
+	object->clearNearbyLights();
+
+	for (int i = 0; i < (int)lights.size(); i++) {
+		if (assignedLightBounds[i].isColliding(bounds)) {
+			object->addNearbyLight(lights[i]);
+		}
+	}
+}
+
+/**
+ * Removes an Object by reference from the Object pointer list and
+ * Object tree, and from the Light pointer list or Skybox if
+ * applicable, before placing it in the disposal queue for deferred
+ * deletion.
  */
 void Scene::removeObject(Object* object) {
 	objects.erase(std::remove(objects.begin(), objects.end(), object), objects.end());
+	objectTree.remove(object);
+
+	addedObjects.erase(std::remove(addedObjects.begin(), addedObjects.end(), object), addedObjects.end());
+
+	reinsertedObjects.erase(std::remove_if(reinsertedObjects.begin(), reinsertedObjects.end(), [&](const auto& entry) {
+		return entry.first == object;
+	}), reinsertedObjects.end());
 
 	if (object->isOfType<Light>()) {
 		lights.erase(std::remove(lights.begin(), lights.end(), object), lights.end());
+
+		shouldReassignLights = true;
+	}
+
+	if (object == skybox) {
+		skybox = NULL;
 	}
 
 	objectDisposalQueue.push_back(object);
@@ -354,6 +532,17 @@ void Scene::safelyFreeMappedParticleSystem(const char* key) {
 			}
 		}
 
+		for (auto* particle : particles) {
+			objectTree.remove(particle);
+		}
+
+		// Rather than searching the pending Object lists for each
+		// Particle, drop them and let every Object be reassigned
+		addedObjects.clear();
+		reinsertedObjects.clear();
+
+		shouldReassignLights = true;
+
 		particleSystemMap.erase(key);
 		particleSystemDisposalQueue.push_back(particleSystem);
 	}
@@ -458,6 +647,11 @@ void Scene::unload() {
 
 	objects.clear();
 	lights.clear();
+	objectTree.clear();
+	addedObjects.clear();
+	reinsertedObjects.clear();
+	shouldReassignLights = true;
+	skybox = NULL;
 	sounds.clear();
 	sectors.clear();
 	objectMap.clear();
@@ -477,3 +671,94 @@ void Scene::updateCurrentOccupiedSectors() {
 		}
 	}
 }
+
+/**
+ * Refits the Object tree to the current bounds of each Object, and
+ * keeps each Object's nearby Lights up to date, sparing the
+ * Illuminator from checking every Light in the Scene against every
+ * vertex. Lights are reassigned to every Object only when the Scene
+ * is first updated or Lights are added or removed; otherwise, only
+ * new Objects, Objects reinserted into the tree, and Objects near
+ * Lights which moved are revisited.
+ */
+void Scene::updateObjectTree() {
+	// Objects reinserted last frame are also lit by Lights near their
+	// previous bounds, which must be dropped once they're out of use
+	relitObjects.clear();
+
+	for (auto& [object, previousBounds] : reinsertedObjects) {
+		relitObjects.push_back(object);
+	}
+
+	reinsertedObjects.clear();
+
+	for (auto* object : objects) {
+		Bounds previousBounds = objectTree.getBounds(object);
+
+		if (objectTree.update(object, getObjectBounds(object))) {
+			reinsertedObjects.push_back({ object, previousBounds });
+		}
+	}
+
+	if (shouldReassignLights) {
+		assignNearbyLights();
+
+		shouldReassignLights = false;
+	} else {
+		relitObjects.insert(relitObjects.end(), addedObjects.begin(), addedObjects.end());
+
+		for (int i = 0; i < (int)lights.size(); i++) {
+			Bounds lightBounds = getLightBounds(lights[i]);
+			Bounds& assignedBounds = assignedLightBounds[i];
+
+			if (
+				lightBounds.cornerA.x == assignedBounds.cornerA.x &&
+				lightBounds.cornerA.y == assignedBounds.cornerA.y &&
+				lightBounds.cornerA.z == assignedBounds.cornerA.z &&
+				lightBounds.cornerB.x == assignedBounds.cornerB.x &&
+				lightBounds.cornerB.y == assignedBounds.cornerB.y &&
+				lightBounds.cornerB.z == assignedBounds.cornerB.z
+			) {
+				continue;
+			}
+
+			// Objects near either the previous or current range
+			// of a moved Light may gain or lose it
+			for (const Bounds& range : { assignedBounds, lightBounds }) {
+				objectTree.query([&](const Bounds& bounds) {
+					return bounds.isColliding(range);
+				}, overlappingObjects, false);
+
+				relitObjects.insert(relitObjects.end(), overlappingObjects.begin(), overlappingObjects.end());
+			}
+
+			assignedBounds = lightBounds;
+		}
+
+		std::sort(relitObjects.begin(), relitObjects.end());
+		relitObjects.erase(std::unique(relitObjects.begin(), relitObjects.end()), relitObjects.end());
+
+		for (auto* object : relitObjects) {
+			reassignNearbyLights(object);
+		}
+	}
+
+	addedObjects.clear();
+
+	// In multithreaded mode, Objects are illuminated a frame after
+	// they're projected, so Objects which were reinserted into the
+	// tree must also be lit by Lights overlapping where they were
+	for (auto& [object, previousBounds] : reinsertedObjects) {
+		const Bounds& bounds = objectTree.getBounds(object);
+
+		object->clearNearbyLights();
+
+		for (int i = 0; i < (int)lights.size(); i++) {
+			const Bounds& lightBounds = assignedLightBounds[i];
+
+			if (lightBounds.isColliding(previousBounds) || lightBounds.isColliding(bounds)) {
+				object->addNearbyLight(lights[i]);
+			}
+		}
+	}
+}